@@ -0,0 +1,1175 @@
+#ifdef DELEGATE_BENCHMARKS
+
+// DelegateBenchmarks.cpp
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Performance benchmarks for the delegate library. Build with -DENABLE_BENCHMARKS=ON
+// (preferably a Release build) and run DelegateApp. Results are printed to stdout.
+
+#include "DelegateLib.h"
+#include "Timer.h"
+#include "DelegateAsyncRequest.h"
+#include "DelegateCoroutine.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <random>
+#if USE_STD_THREADS
+	#include "WorkerThreadStd.h"
+	#include "WorkerThreadMpsc.h"
+	#include "WorkerThreadPool.h"
+	#include "WorkerStrand.h"
+#endif
+
+using namespace DelegateLib;
+using namespace std::chrono;
+
+namespace {
+
+std::atomic<int> g_received(0);
+
+void BenchmarkFunc(int) { g_received.fetch_add(1, std::memory_order_relaxed); }
+
+/// Post msgsPerProducer async delegate calls from each of producers threads to
+/// the target thread.
+/// @return Throughput in messages per second measured until the target thread
+/// has run every posted message.
+template <class TThread>
+double DispatchThroughput(TThread& thread, int producers, int msgsPerProducer)
+{
+	const int total = producers * msgsPerProducer;
+	g_received = 0;
+
+	auto start = steady_clock::now();
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producers; p++)
+	{
+		threads.emplace_back([&thread, msgsPerProducer]() {
+			auto delegate = MakeDelegate(&BenchmarkFunc, thread);
+			for (int i = 0; i < msgsPerProducer; i++)
+				delegate(i);
+		});
+	}
+	for (auto& t : threads)
+		t.join();
+
+	while (g_received.load(std::memory_order_relaxed) < total)
+		std::this_thread::yield();
+
+	duration<double> elapsed = steady_clock::now() - start;
+	return total / elapsed.count();
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+// DispatchQueueBenchmark
+//------------------------------------------------------------------------------
+// Compares the mutex and condition variable WorkerThread queue against the
+// lock-free WorkerThreadMpsc queue with 1 to 16 producer threads.
+static void DispatchQueueBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 200000;
+
+	WorkerThread mutexThread("BenchmarkMutexThread");
+	WorkerThreadMpsc mpscThread("BenchmarkMpscThread");
+	mutexThread.CreateThread();
+	mpscThread.CreateThread();
+
+	std::cout << "Dispatch queue throughput (msgs/sec)" << std::endl;
+	std::cout << std::setw(10) << "producers" << std::setw(16) << "WorkerThread" << std::setw(20) << "WorkerThreadMpsc" << std::endl;
+	for (int producers : { 1, 2, 4, 8, 16 })
+	{
+		double mutexRate = DispatchThroughput(mutexThread, producers, MSGS / producers);
+		double mpscRate = DispatchThroughput(mpscThread, producers, MSGS / producers);
+		std::cout << std::setw(10) << producers
+			<< std::setw(16) << std::fixed << std::setprecision(0) << mutexRate
+			<< std::setw(20) << mpscRate << std::endl;
+	}
+
+	mutexThread.ExitThread();
+	mpscThread.ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// ReceivePathBenchmark
+//------------------------------------------------------------------------------
+// Measures the cost a target thread pays to invoke an already queued message:
+// virtual IDelegateInvoker::DelegateInvoke() versus the typed trampoline used
+// by DelegateMsgBase::Invoke().
+static void ReceivePathBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 10000000;
+
+	// The thread is never started; messages are invoked directly on this thread
+	WorkerThread thread("BenchmarkReceiveThread");
+	auto delegate = std::make_shared<DelegateFreeAsync<void(int)>>(&BenchmarkFunc, thread);
+	std::shared_ptr<DelegateMsgBase> msg = std::make_shared<DelegateMsgHeapArgs<int>>(delegate, 1);
+
+	g_received = 0;
+	auto start = steady_clock::now();
+	for (int i = 0; i < MSGS; i++)
+		msg->GetDelegateInvoker()->DelegateInvoke(msg);
+	duration<double, std::nano> virtualTime = steady_clock::now() - start;
+
+	msg->SetInvokeFunc(&DelegateFreeAsync<void(int)>::InvokeTrampoline);
+	start = steady_clock::now();
+	for (int i = 0; i < MSGS; i++)
+		DelegateMsgBase::Invoke(msg);
+	duration<double, std::nano> trampolineTime = steady_clock::now() - start;
+
+	std::cout << "Receive path (ns/msg)" << std::endl;
+	std::cout << std::setw(16) << "DelegateInvoke" << std::setw(12) << "Trampoline" << std::endl;
+	std::cout << std::setw(16) << std::fixed << std::setprecision(2) << virtualTime.count() / MSGS
+		<< std::setw(12) << trampolineTime.count() / MSGS << std::endl;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// BatchDispatchBenchmark
+//------------------------------------------------------------------------------
+// Compares posting messages one call at a time against InvokeBatch(), which
+// enqueues a whole batch with one lock and one wake-up.
+static void BatchDispatchBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 1000000;
+
+	WorkerThread thread("BenchmarkBatchThread");
+	thread.CreateThread();
+	auto delegate = MakeDelegate(&BenchmarkFunc, thread);
+
+	std::cout << "Batch dispatch throughput (msgs/sec)" << std::endl;
+	std::cout << std::setw(10) << "batch" << std::setw(16) << "operator()" << std::setw(16) << "InvokeBatch" << std::endl;
+	for (int batch : { 1, 8, 64, 512 })
+	{
+		g_received = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < MSGS; i++)
+			delegate(i);
+		while (g_received.load(std::memory_order_relaxed) < MSGS)
+			std::this_thread::yield();
+		duration<double> singleTime = steady_clock::now() - start;
+
+		g_received = 0;
+		start = steady_clock::now();
+		std::vector<std::tuple<int>> calls;
+		for (int i = 0; i < MSGS; i += batch)
+		{
+			calls.clear();
+			for (int j = 0; j < batch; j++)
+				calls.emplace_back(i + j);
+			delegate.InvokeBatch(calls);
+		}
+		while (g_received.load(std::memory_order_relaxed) < MSGS)
+			std::this_thread::yield();
+		duration<double> batchTime = steady_clock::now() - start;
+
+		std::cout << std::setw(10) << batch
+			<< std::setw(16) << std::fixed << std::setprecision(0) << MSGS / singleTime.count()
+			<< std::setw(16) << MSGS / batchTime.count() << std::endl;
+	}
+
+	thread.ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// SpinLatencyBenchmark
+//------------------------------------------------------------------------------
+// Measures the time from posting a message to the target function running when
+// messages arrive shortly after one another, with and without spinning before
+// the worker blocks.
+static void SpinLatencyBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 20000;
+
+	std::cout << "Closely spaced message latency (us)" << std::endl;
+	std::cout << std::setw(10) << "spin" << std::setw(16) << "avg" << std::endl;
+	for (int spin : { 0, 16, 256 })
+	{
+		WorkerThread thread("BenchmarkSpinThread");
+		thread.SetSpinCount(spin);
+		thread.CreateThread();
+		auto delegate = MakeDelegate(&BenchmarkFunc, thread);
+
+		g_received = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < MSGS; i++)
+		{
+			delegate(i);
+			while (g_received.load(std::memory_order_relaxed) <= i)
+				std::this_thread::yield();
+		}
+		duration<double, std::micro> elapsed = steady_clock::now() - start;
+
+		std::cout << std::setw(10) << spin << std::setw(16) << std::fixed << std::setprecision(2) << elapsed.count() / MSGS << std::endl;
+		thread.ExitThread();
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// TimerJitterBenchmark
+//------------------------------------------------------------------------------
+// Measures how late each periodic Timer callback runs relative to its ideal
+// deadline (start time plus a whole number of periods), and how many periods
+// were skipped because a callback ran more than one period late.
+static const size_t TIMER_TICKS = 1000;
+static steady_clock::time_point timerTimes[TIMER_TICKS];
+static std::atomic<size_t> timerTicks(0);
+
+static void TimerJitterFunc()
+{
+	size_t tick = timerTicks.load(std::memory_order_relaxed);
+	if (tick < TIMER_TICKS)
+	{
+		timerTimes[tick] = steady_clock::now();
+		timerTicks.store(tick + 1, std::memory_order_release);
+	}
+}
+
+static void TimerJitterBenchmark()
+{
+	const size_t TICKS = TIMER_TICKS;
+
+	std::cout << "Timer lateness (us)" << std::endl;
+	std::cout << std::setw(10) << "period" << std::setw(12) << "avg" << std::setw(12) << "p99" << std::setw(12) << "max" << std::setw(10) << "skipped" << std::endl;
+	for (auto period : { microseconds(1000), microseconds(500) })
+	{
+		timerTicks = 0;
+
+		// Expired is invoked directly on the timer thread
+		Timer timer;
+		timer.Expired = MakeDelegate(&TimerJitterFunc);
+		auto start = steady_clock::now();
+		timer.Start(period);
+		while (timerTicks.load(std::memory_order_acquire) < TICKS)
+			std::this_thread::sleep_for(milliseconds(10));
+		timer.Stop();
+
+		std::vector<double> lateness;
+		long long deadlines = 0;
+		for (size_t i = 0; i < TICKS; i++)
+		{
+			deadlines = (timerTimes[i] - start) / period;
+			duration<double, std::micro> late = timerTimes[i] - (start + period * deadlines);
+			lateness.push_back(late.count());
+		}
+		double avg = 0;
+		for (double late : lateness)
+			avg += late;
+		avg /= TICKS;
+		std::sort(lateness.begin(), lateness.end());
+
+		std::cout << std::setw(10) << period.count() << std::fixed << std::setprecision(2)
+			<< std::setw(12) << avg << std::setw(12) << lateness[TICKS * 99 / 100]
+			<< std::setw(12) << lateness.back() << std::setw(10) << deadlines - (long long)TICKS << std::endl;
+	}
+}
+
+//------------------------------------------------------------------------------
+// MulticastPublishBenchmark
+//------------------------------------------------------------------------------
+// Compares the cost of invoking a multicast delegate with 4 subscribers from 1
+// to 8 publishing threads. MulticastDelegateSafe holds its mutex for the whole
+// broadcast; MulticastDelegateRcu takes no lock.
+template <class TMulticast>
+static double PublishTime(TMulticast& multicast, int publishers, int publishesPerThread)
+{
+	auto start = steady_clock::now();
+	std::vector<std::thread> threads;
+	for (int p = 0; p < publishers; p++)
+	{
+		threads.emplace_back([&multicast, publishesPerThread]() {
+			for (int i = 0; i < publishesPerThread; i++)
+				multicast(i);
+		});
+	}
+	for (auto& t : threads)
+		t.join();
+	duration<double, std::nano> elapsed = steady_clock::now() - start;
+	return elapsed.count() / (publishers * publishesPerThread);
+}
+
+static void MulticastPublishBenchmark()
+{
+	const int PUBLISHES = 1000000;
+
+	MulticastDelegateSafe<void(int)> safe;
+	MulticastDelegateRcu<void(int)> rcu;
+	for (int i = 0; i < 4; i++)
+	{
+		safe += MakeDelegate(&BenchmarkFunc);
+		rcu += MakeDelegate(&BenchmarkFunc);
+	}
+
+	std::cout << "Multicast publish (ns/publish)" << std::endl;
+	std::cout << std::setw(10) << "threads" << std::setw(24) << "MulticastDelegateSafe" << std::setw(24) << "MulticastDelegateRcu" << std::endl;
+	for (int publishers : { 1, 2, 4, 8 })
+	{
+		double safeTime = PublishTime(safe, publishers, PUBLISHES / publishers);
+		double rcuTime = PublishTime(rcu, publishers, PUBLISHES / publishers);
+		std::cout << std::setw(10) << publishers << std::fixed << std::setprecision(2)
+			<< std::setw(24) << safeTime << std::setw(24) << rcuTime << std::endl;
+	}
+}
+
+//------------------------------------------------------------------------------
+// MulticastBroadcastBenchmark
+//------------------------------------------------------------------------------
+// Compares the cost of one MulticastDelegate broadcast against the previous
+// std::list<Delegate*> invocation list at 1 to 1000 subscribers. Each list 
+// delegate is allocated between unrelated allocations, as in a long running program.
+class BroadcastTarget
+{
+public:
+	void Func(int i) { m_sum += i; }
+	int m_sum = 0;
+};
+
+static void MulticastBroadcastBenchmark()
+{
+	const int BROADCASTS = 2000000;
+
+	std::cout << "Multicast broadcast (ns/broadcast)" << std::endl;
+	std::cout << std::setw(12) << "subscribers" << std::setw(12) << "std::list" << std::setw(20) << "MulticastDelegate" << std::endl;
+	for (int subscribers : { 1, 10, 100, 1000 })
+	{
+		std::vector<BroadcastTarget> targets(subscribers);
+		std::vector<std::unique_ptr<char[]>> scatter;
+
+		std::list<Delegate<void(int)>*> list;
+		MulticastDelegate<void(int)> multicast;
+		for (auto& target : targets)
+		{
+			list.push_back(MakeDelegate(&target, &BroadcastTarget::Func).Clone());
+			scatter.emplace_back(new char[64 + 32 * (scatter.size() % 8)]);
+			multicast += MakeDelegate(&target, &BroadcastTarget::Func);
+		}
+
+		const int iterations = BROADCASTS / subscribers;
+		auto start = steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+		{
+			for (auto delegate : list)
+				(*delegate)(i);
+		}
+		duration<double, std::nano> listTime = steady_clock::now() - start;
+
+		start = steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			multicast(i);
+		duration<double, std::nano> multicastTime = steady_clock::now() - start;
+
+		std::cout << std::setw(12) << subscribers << std::fixed << std::setprecision(2)
+			<< std::setw(12) << listTime.count() / iterations 
+			<< std::setw(20) << multicastTime.count() / iterations << std::endl;
+
+		for (auto delegate : list)
+			delete delegate;
+	}
+}
+
+//------------------------------------------------------------------------------
+// DelegateValueBenchmark
+//------------------------------------------------------------------------------
+// Compares storing a copy of a member function delegate and comparing it for
+// equality: Clone() and the RTTI operator== of a polymorphic delegate versus
+// a DelegateValue<> copy and byte compare.
+static void DelegateValueBenchmark()
+{
+	const int COPIES = 1000000;
+	BroadcastTarget target;
+
+	auto delegate = MakeDelegate(&target, &BroadcastTarget::Func);
+	std::vector<Delegate<void(int)>*> clones;
+	clones.reserve(COPIES);
+	auto start = steady_clock::now();
+	for (int i = 0; i < COPIES; i++)
+		clones.push_back(delegate.Clone());
+	int equal = 0;
+	for (auto clone : clones)
+		equal += (*clone == delegate);
+	for (auto clone : clones)
+		delete clone;
+	duration<double, std::nano> cloneTime = steady_clock::now() - start;
+
+	DelegateValue<void(int)> value(&target, &BroadcastTarget::Func);
+	std::vector<DelegateValue<void(int)>> values;
+	values.reserve(COPIES);
+	start = steady_clock::now();
+	for (int i = 0; i < COPIES; i++)
+		values.push_back(value);
+	for (auto& copy : values)
+		equal += (copy == value);
+	values.clear();
+	duration<double, std::nano> valueTime = steady_clock::now() - start;
+
+	std::cout << "Delegate copy and compare (ns/delegate)" << std::endl;
+	std::cout << std::setw(16) << "Clone()" << std::setw(16) << "DelegateValue" << std::endl;
+	std::cout << std::setw(16) << std::fixed << std::setprecision(2) << cloneTime.count() / COPIES
+		<< std::setw(16) << valueTime.count() / COPIES << std::endl;
+	if (equal != COPIES * 2)
+		std::cout << "Error: delegate compare failed" << std::endl;
+}
+
+//------------------------------------------------------------------------------
+// MulticastChurnBenchmark
+//------------------------------------------------------------------------------
+// Measures subscribing then unsubscribing every subscriber of a MulticastDelegate, 
+// in random order, using operator-= versus the DelegateConnection returned by +=.
+static void MulticastChurnBenchmark()
+{
+	std::cout << "Multicast churn (ns/subscribe+unsubscribe)" << std::endl;
+	std::cout << std::setw(12) << "subscribers" << std::setw(16) << "operator-=" << std::setw(16) << "Disconnect()" << std::endl;
+	for (int subscribers : { 10, 100, 1000, 5000 })
+	{
+		std::vector<BroadcastTarget> targets(subscribers);
+		std::vector<int> order(subscribers);
+		for (int i = 0; i < subscribers; i++)
+			order[i] = i;
+		std::shuffle(order.begin(), order.end(), std::mt19937(subscribers));
+
+		const int rounds = std::max(1, 20000 / subscribers);
+		MulticastDelegate<void(int)> multicast;
+		auto start = steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+		{
+			for (auto& target : targets)
+				multicast += MakeDelegate(&target, &BroadcastTarget::Func);
+			for (int i : order)
+				multicast -= MakeDelegate(&targets[i], &BroadcastTarget::Func);
+		}
+		duration<double, std::nano> removeTime = steady_clock::now() - start;
+
+		std::vector<DelegateConnection> connections(subscribers);
+		start = steady_clock::now();
+		for (int r = 0; r < rounds; r++)
+		{
+			for (int i = 0; i < subscribers; i++)
+				connections[i] = multicast += MakeDelegate(&targets[i], &BroadcastTarget::Func);
+			for (int i : order)
+				connections[i].Disconnect();
+		}
+		duration<double, std::nano> disconnectTime = steady_clock::now() - start;
+
+		const double count = double(rounds) * subscribers;
+		std::cout << std::setw(12) << subscribers << std::fixed << std::setprecision(2)
+			<< std::setw(16) << removeTime.count() / count
+			<< std::setw(16) << disconnectTime.count() / count << std::endl;
+		if (!multicast.Empty())
+			std::cout << "Error: multicast not empty" << std::endl;
+	}
+}
+
+//------------------------------------------------------------------------------
+// MulticastFanOutBenchmark
+//------------------------------------------------------------------------------
+// Compares publishing a 1 KB payload to asynchronous subscribers spread over
+// 4 threads using operator(), which copies the payload per subscriber, against
+// Broadcast(), which copies it once and posts one message per thread.
+struct FanOutPayload
+{
+	char data[1024];
+};
+
+static std::atomic<int> g_fanOutReceived(0);
+
+static void FanOutFunc(const FanOutPayload&) { g_fanOutReceived.fetch_add(1, std::memory_order_relaxed); }
+
+static void MulticastFanOutBenchmark()
+{
+#if USE_STD_THREADS
+	const int THREADS = 4;
+	const int PUBLISHES = 20000;
+
+	std::vector<std::unique_ptr<WorkerThread>> threads;
+	for (int t = 0; t < THREADS; t++)
+	{
+		threads.emplace_back(new WorkerThread("BenchmarkFanOutThread"));
+		threads.back()->CreateThread();
+	}
+
+	FanOutPayload payload = {};
+	std::cout << "Multicast fan-out, 1 KB payload, 4 threads (ns/publish)" << std::endl;
+	std::cout << std::setw(12) << "subscribers" << std::setw(16) << "operator()" << std::setw(16) << "Broadcast()" << std::endl;
+	for (int subscribers : { 4, 16, 64 })
+	{
+		MulticastDelegate<void(const FanOutPayload&)> multicast;
+		for (int i = 0; i < subscribers; i++)
+			multicast += MakeDelegate(&FanOutFunc, *threads[i % THREADS]);
+
+		const int publishes = PUBLISHES * 4 / subscribers;
+		const int total = publishes * subscribers;
+		double times[2];
+		for (int mode = 0; mode < 2; mode++)
+		{
+			g_fanOutReceived = 0;
+			auto start = steady_clock::now();
+			for (int i = 0; i < publishes; i++)
+			{
+				if (mode == 0)
+					multicast(payload);
+				else
+					multicast.Broadcast(payload);
+			}
+			while (g_fanOutReceived.load(std::memory_order_relaxed) < total)
+				std::this_thread::yield();
+			duration<double, std::nano> elapsed = steady_clock::now() - start;
+			times[mode] = elapsed.count() / publishes;
+		}
+
+		std::cout << std::setw(12) << subscribers << std::fixed << std::setprecision(0)
+			<< std::setw(16) << times[0] << std::setw(16) << times[1] << std::endl;
+	}
+
+	for (auto& thread : threads)
+		thread->ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// ThreadPoolScalingBenchmark
+//------------------------------------------------------------------------------
+// Measures the throughput of a CPU bound callback on a WorkerThreadPool of 1
+// worker up to the hardware concurrency, against a single WorkerThread.
+static std::atomic<int> g_poolReceived(0);
+
+static void PoolWorkFunc(int seed) 
+{
+	// About a microsecond of work that the compiler cannot remove
+	volatile unsigned value = seed;
+	for (int i = 0; i < 500; i++)
+		value = value * 1664525u + 1013904223u;
+	g_poolReceived.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <class TThread>
+static double PoolThroughput(TThread& thread, int msgs)
+{
+	g_poolReceived = 0;
+	auto delegate = MakeDelegate(&PoolWorkFunc, thread);
+	delegate.SetInlineDispatch(true);
+	auto start = steady_clock::now();
+	for (int i = 0; i < msgs; i++)
+		delegate(i);
+	while (g_poolReceived.load(std::memory_order_relaxed) < msgs)
+		std::this_thread::yield();
+	duration<double> elapsed = steady_clock::now() - start;
+	return msgs / elapsed.count();
+}
+
+static void ThreadPoolScalingBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 200000;
+
+	WorkerThread single("BenchmarkSingleThread");
+	single.CreateThread();
+	const double singleRate = PoolThroughput(single, MSGS);
+	single.ExitThread();
+
+	std::cout << "Thread pool scaling, ~1 us callback (msgs/sec)" << std::endl;
+	std::cout << std::setw(10) << "workers" << std::setw(16) << "WorkerThread" << std::setw(20) << "WorkerThreadPool" << std::endl;
+	const int cores = std::max(1u, std::thread::hardware_concurrency());
+	for (int workers = 1; ; workers = std::min(workers * 2, cores))
+	{
+		WorkerThreadPool pool("BenchmarkPool", workers);
+		pool.CreateThread();
+		const double poolRate = PoolThroughput(pool, MSGS);
+		pool.ExitThread();
+
+		std::cout << std::setw(10) << workers << std::fixed << std::setprecision(0)
+			<< std::setw(16) << singleRate << std::setw(20) << poolRate << std::endl;
+		if (workers == cores)
+			break;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// StrandBenchmark
+//------------------------------------------------------------------------------
+// Compares running many components, each needing ordered non-concurrent
+// callbacks, on a WorkerThread per component versus a WorkerStrand per
+// component sharing one WorkerThreadPool.
+static void StrandBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 200000;
+
+	std::cout << "Components on threads vs strands (msgs/sec)" << std::endl;
+	std::cout << std::setw(12) << "components" << std::setw(16) << "WorkerThread" << std::setw(16) << "WorkerStrand" << std::endl;
+	for (int components : { 4, 64, 256 })
+	{
+		const int perComponent = MSGS / components;
+		const int total = perComponent * components;
+		double rates[2];
+		for (int mode = 0; mode < 2; mode++)
+		{
+			std::vector<std::unique_ptr<WorkerThread>> threads;
+			WorkerThreadPool pool("BenchmarkStrandPool");
+			std::vector<std::unique_ptr<WorkerStrand>> strands;
+			std::vector<DelegateThread*> targets;
+			if (mode == 0)
+			{
+				for (int c = 0; c < components; c++)
+				{
+					threads.emplace_back(new WorkerThread("BenchmarkComponentThread"));
+					threads.back()->CreateThread();
+					targets.push_back(threads.back().get());
+				}
+			}
+			else
+			{
+				pool.CreateThread();
+				for (int c = 0; c < components; c++)
+				{
+					strands.emplace_back(new WorkerStrand(pool));
+					targets.push_back(strands.back().get());
+				}
+			}
+
+			g_poolReceived = 0;
+			auto start = steady_clock::now();
+			for (int i = 0; i < perComponent; i++)
+			{
+				for (auto target : targets)
+					MakeDelegate(&PoolWorkFunc, *target)(i);
+			}
+			while (g_poolReceived.load(std::memory_order_relaxed) < total)
+				std::this_thread::yield();
+			duration<double> elapsed = steady_clock::now() - start;
+			rates[mode] = total / elapsed.count();
+
+			for (auto& thread : threads)
+				thread->ExitThread();
+			pool.ExitThread();
+		}
+
+		std::cout << std::setw(12) << components << std::fixed << std::setprecision(0)
+			<< std::setw(16) << rates[0] << std::setw(16) << rates[1] << std::endl;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// PriorityLatencyBenchmark
+//------------------------------------------------------------------------------
+// Measures the latency of a periodic control message on a WorkerThread while
+// another thread floods it with telemetry messages. Compares a single FIFO
+// priority against HIGH priority control messages over a LOW priority flood.
+static std::vector<double> g_controlLatency;
+
+static void ControlFunc(steady_clock::time_point sent)
+{
+	g_controlLatency.push_back(duration<double, std::micro>(steady_clock::now() - sent).count());
+}
+
+static void PriorityLatencyBenchmark()
+{
+#if USE_STD_THREADS
+	const int SAMPLES = 1000;
+	const int BACKLOG = 2000;
+
+	std::cout << "Control message latency under a flood (us)" << std::endl;
+	std::cout << std::setw(20) << "control/flood" << std::setw(12) << "p50" << std::setw(12) << "p99" << std::endl;
+	for (int mode = 0; mode < 2; mode++)
+	{
+		WorkerThread thread("BenchmarkPriorityThread");
+		thread.CreateThread();
+		auto flood = MakeDelegate(&PoolWorkFunc, thread);
+		auto control = MakeDelegate(&ControlFunc, thread);
+		if (mode == 1)
+		{
+			flood.SetPriority(DelegatePriority::LOW);
+			control.SetPriority(DelegatePriority::HIGH);
+		}
+
+		// Keep about BACKLOG flood messages queued
+		g_poolReceived = 0;
+		std::atomic<bool> done(false);
+		std::thread flooder([&flood, &done, BACKLOG]() {
+			int sent = 0;
+			while (!done)
+			{
+				if (sent - g_poolReceived.load(std::memory_order_relaxed) < BACKLOG)
+					flood(sent++);
+				else
+					std::this_thread::yield();
+			}
+		});
+		while (g_poolReceived.load() == 0)
+			std::this_thread::yield();
+
+		g_controlLatency.clear();
+		g_controlLatency.reserve(SAMPLES);
+		for (int i = 0; i < SAMPLES; i++)
+		{
+			control(steady_clock::now());
+			std::this_thread::sleep_for(microseconds(200));
+		}
+		done = true;
+		flooder.join();
+		thread.ExitThread();
+
+		std::sort(g_controlLatency.begin(), g_controlLatency.end());
+		const size_t count = g_controlLatency.size();
+		std::cout << std::setw(20) << (mode == 0 ? "NORMAL/NORMAL" : "HIGH/LOW") << std::fixed << std::setprecision(1)
+			<< std::setw(12) << (count ? g_controlLatency[count / 2] : 0.0)
+			<< std::setw(12) << (count ? g_controlLatency[count * 99 / 100] : 0.0) << std::endl;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// OverflowPolicyBenchmark
+//------------------------------------------------------------------------------
+// A producer floods a WorkerThread whose ~1 us callback cannot keep up. Reports
+// the peak backlog of dispatched but not yet invoked messages, which bounds the 
+// queue memory, for an unbounded queue and each bounded queue overflow policy.
+static void OverflowPolicyBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 200000;
+	const size_t CAPACITY = 1024;
+	const struct { const char* name; size_t capacity; WorkerThread::OverflowPolicy policy; } modes[] = {
+		{ "unbounded", 0, WorkerThread::OverflowPolicy::BLOCK },
+		{ "BLOCK", CAPACITY, WorkerThread::OverflowPolicy::BLOCK },
+		{ "DROP_NEWEST", CAPACITY, WorkerThread::OverflowPolicy::DROP_NEWEST },
+		{ "DROP_OLDEST", CAPACITY, WorkerThread::OverflowPolicy::DROP_OLDEST },
+	};
+
+	std::cout << "Overflow policy, producer flooding a ~1 us callback" << std::endl;
+	std::cout << std::setw(14) << "policy" << std::setw(14) << "peak backlog" << std::setw(12) << "delivered"
+		<< std::setw(12) << "dropped" << std::setw(14) << "msgs/sec" << std::endl;
+	for (auto& mode : modes)
+	{
+		WorkerThread thread("BenchmarkOverflowThread");
+		thread.SetQueueCapacity(mode.capacity, mode.policy);
+		thread.CreateThread();
+		auto delegate = MakeDelegate(&PoolWorkFunc, thread);
+		delegate.SetInlineDispatch(true);
+
+		g_poolReceived = 0;
+		int peak = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < MSGS; i++)
+		{
+			delegate(i);
+			peak = std::max(peak, i + 1 - static_cast<int>(thread.GetDroppedCount()) - g_poolReceived.load(std::memory_order_relaxed));
+		}
+		const int delivered = MSGS - static_cast<int>(thread.GetDroppedCount());
+		while (g_poolReceived.load(std::memory_order_relaxed) < delivered)
+			std::this_thread::yield();
+		duration<double> elapsed = steady_clock::now() - start;
+		thread.ExitThread();
+
+		std::cout << std::setw(14) << mode.name << std::setw(14) << peak << std::setw(12) << delivered
+			<< std::setw(12) << thread.GetDroppedCount() << std::fixed << std::setprecision(0)
+			<< std::setw(14) << delivered / elapsed.count() << std::endl;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// ConflationBenchmark
+//------------------------------------------------------------------------------
+// A producer publishes "latest value wins" updates faster than a ~5 us callback
+// consumes them. Reports the callbacks invoked and the time until the consumer 
+// has processed the final value, with and without conflation.
+static std::atomic<int> g_conflateLast(-1);
+static std::atomic<int> g_conflateCalls(0);
+
+static void ConflateFunc(int value)
+{
+	volatile unsigned work = value;
+	for (int i = 0; i < 2500; i++)
+		work = work * 1664525u + 1013904223u;
+	g_conflateCalls.fetch_add(1, std::memory_order_relaxed);
+	g_conflateLast.store(value);
+}
+
+static void ConflationBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 100000;
+
+	std::cout << "Conflation, updates to a ~5 us callback" << std::endl;
+	std::cout << std::setw(12) << "mode" << std::setw(14) << "callbacks" << std::setw(18) << "latest seen (ms)" << std::endl;
+	for (int conflate = 0; conflate < 2; conflate++)
+	{
+		WorkerThread thread("BenchmarkConflateThread");
+		thread.CreateThread();
+		auto delegate = MakeDelegate(&ConflateFunc, thread);
+		delegate.SetInlineDispatch(true);
+		delegate.SetConflate(conflate == 1);
+
+		g_conflateLast = -1;
+		g_conflateCalls = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < MSGS; i++)
+			delegate(i);
+		while (g_conflateLast.load() != MSGS - 1)
+			std::this_thread::yield();
+		duration<double, std::milli> elapsed = steady_clock::now() - start;
+		thread.ExitThread();
+
+		std::cout << std::setw(12) << (conflate ? "conflate" : "queue all") << std::setw(14) << g_conflateCalls.load()
+			<< std::fixed << std::setprecision(1) << std::setw(18) << elapsed.count() << std::endl;
+	}
+#endif
+}
+
+//------------------------------------------------------------------------------
+// FutureBenchmark
+//------------------------------------------------------------------------------
+// A caller requests a result from each of three threads whose target function 
+// takes ~1 ms, e.g. waiting on a device. Blocking wait delegates pay the round 
+// trips one after another. Futures issue all three requests before collecting.
+static int ServiceFunc(int value)
+{
+	std::this_thread::sleep_for(milliseconds(1));
+	return value + 1;
+}
+
+static void FutureBenchmark()
+{
+#if USE_STD_THREADS
+	const int ROUNDS = 200;
+	const int SERVICES = 3;
+
+	WorkerThread threads[SERVICES] = { "BenchmarkServiceThread0", "BenchmarkServiceThread1", "BenchmarkServiceThread2" };
+	std::vector<DelegateFreeAsyncWait<int(int)>> services;
+	for (auto& thread : threads)
+	{
+		thread.CreateThread();
+		services.push_back(MakeDelegate(&ServiceFunc, thread, WAIT_INFINITE));
+	}
+
+	std::cout << "Requests to " << SERVICES << " threads, ~1 ms each" << std::endl;
+	std::cout << std::setw(12) << "mode" << std::setw(18) << "per round (ms)" << std::endl;
+	for (int future = 0; future < 2; future++)
+	{
+		int sum = 0;
+		auto start = steady_clock::now();
+		for (int round = 0; round < ROUNDS; round++)
+		{
+			if (future)
+			{
+				std::vector<DelegateFuture<int>> results;
+				for (auto& service : services)
+					results.push_back(service.AsyncInvokeFuture(round));
+				for (auto& result : results)
+					sum += result.Get().value_or(0);
+			}
+			else
+			{
+				for (auto& service : services)
+					sum += service.AsyncInvoke(round).value_or(0);
+			}
+		}
+		duration<double, std::milli> elapsed = steady_clock::now() - start;
+		if (sum != SERVICES * ROUNDS * (ROUNDS + 1) / 2)
+			std::cout << "Unexpected result " << sum << std::endl;
+
+		std::cout << std::setw(12) << (future ? "future" : "wait") 
+			<< std::fixed << std::setprecision(2) << std::setw(18) << elapsed.count() / ROUNDS << std::endl;
+	}
+
+	for (auto& thread : threads)
+		thread.ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// ScatterGatherBenchmark
+//------------------------------------------------------------------------------
+// A health check queries 20 subsystem threads, each answering in ~1 ms. Reports 
+// the time per health check calling each subsystem in turn, and dispatching all
+// calls before gathering the results with WhenAll().
+static bool HealthCheckFunc()
+{
+	std::this_thread::sleep_for(milliseconds(1));
+	return true;
+}
+
+static void ScatterGatherBenchmark()
+{
+#if USE_STD_THREADS
+	const int ROUNDS = 50;
+	const int SUBSYSTEMS = 20;
+
+	std::vector<std::unique_ptr<WorkerThread>> threads;
+	std::vector<DelegateFreeAsyncWait<bool()>> checks;
+	for (int i = 0; i < SUBSYSTEMS; i++)
+	{
+		threads.push_back(std::make_unique<WorkerThread>("BenchmarkSubsystemThread"));
+		threads.back()->CreateThread();
+		checks.push_back(MakeDelegate(&HealthCheckFunc, *threads.back(), milliseconds(100)));
+	}
+
+	std::cout << "Health check of " << SUBSYSTEMS << " threads, ~1 ms each" << std::endl;
+	std::cout << std::setw(12) << "mode" << std::setw(18) << "per check (ms)" << std::endl;
+	for (int gather = 0; gather < 2; gather++)
+	{
+		int healthy = 0;
+		auto start = steady_clock::now();
+		for (int round = 0; round < ROUNDS; round++)
+		{
+			if (gather)
+			{
+				std::vector<DelegateFuture<bool>> futures;
+				for (auto& check : checks)
+					futures.push_back(check.AsyncInvokeFuture());
+				for (auto& result : WhenAll(futures, milliseconds(100)))
+					healthy += result.value_or(false) ? 1 : 0;
+			}
+			else
+			{
+				for (auto& check : checks)
+					healthy += check.AsyncInvoke().value_or(false) ? 1 : 0;
+			}
+		}
+		duration<double, std::milli> elapsed = steady_clock::now() - start;
+		if (healthy != ROUNDS * SUBSYSTEMS)
+			std::cout << "Unhealthy results " << ROUNDS * SUBSYSTEMS - healthy << std::endl;
+
+		std::cout << std::setw(12) << (gather ? "WhenAll" : "sequential") 
+			<< std::fixed << std::setprecision(2) << std::setw(18) << elapsed.count() / ROUNDS << std::endl;
+	}
+
+	for (auto& thread : threads)
+		thread->ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// RequestReplyBenchmark
+//------------------------------------------------------------------------------
+// A client issues requests to a server thread and needs every result. Reports
+// requests per second blocking on each with a wait delegate, and issuing all of
+// them as request/response delegates replying to a client thread, without and 
+// with a reply timeout.
+static std::atomic<int> g_replies(0);
+
+static int RequestFunc(int value) { return value + 1; }
+static void ReplyFunc(int value) { g_replies.fetch_add(1, std::memory_order_relaxed); }
+static void ReplyTimeoutFunc() { }
+
+static void RequestReplyBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 20000;
+
+	WorkerThread server("BenchmarkRequestServer");
+	WorkerThread client("BenchmarkRequestClient");
+	server.CreateThread();
+	client.CreateThread();
+
+	std::cout << "Request/response, " << MSGS << " requests" << std::endl;
+	std::cout << std::setw(16) << "mode" << std::setw(14) << "msgs/sec" << std::endl;
+	for (int mode = 0; mode < 3; mode++)
+	{
+		auto wait = MakeDelegate(&RequestFunc, server, mode == 2 ? milliseconds(1000) : WAIT_INFINITE);
+		auto request = MakeDelegate(wait, MakeDelegate(&ReplyFunc, client), MakeDelegate(&ReplyTimeoutFunc, client));
+
+		g_replies = 0;
+		auto start = steady_clock::now();
+		for (int i = 0; i < MSGS; i++)
+		{
+			if (mode == 0)
+				ReplyFunc(wait.AsyncInvoke(i).value_or(0));
+			else
+				request(i);
+		}
+		while (g_replies.load() != MSGS)
+			std::this_thread::yield();
+		duration<double> elapsed = steady_clock::now() - start;
+
+		const char* name = mode == 0 ? "wait" : mode == 1 ? "reply" : "reply+timeout";
+		std::cout << std::setw(16) << name << std::fixed << std::setprecision(0) 
+			<< std::setw(14) << MSGS / elapsed.count() << std::endl;
+	}
+
+	server.ExitThread();
+	client.ExitThread();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// CoroutineBenchmark
+//------------------------------------------------------------------------------
+// Round trips from a client thread to a server thread and back, returning a value.
+// Reports round trips per second for a blocking wait delegate and for a coroutine
+// awaiting the same delegate, which suspends instead of blocking the client thread.
+// Requires a compiler with C++20 coroutines.
+#if USE_STD_THREADS && defined(__cpp_impl_coroutine)
+struct BenchmarkCoroutine
+{
+	struct promise_type
+	{
+		BenchmarkCoroutine get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() { }
+		void unhandled_exception() { }
+	};
+};
+
+static std::atomic<bool> g_roundTripsDone(false);
+static DelegateFreeAsyncWait<int(int)>* g_roundTripRequest = nullptr;
+
+static void WaitRoundTrips(int msgs)
+{
+	int sum = 0;
+	for (int i = 0; i < msgs; i++)
+		sum += g_roundTripRequest->AsyncInvoke(i).value_or(0);
+	g_roundTripsDone = sum != 0;
+}
+
+static BenchmarkCoroutine AwaitRoundTrips(int msgs)
+{
+	int sum = 0;
+	for (int i = 0; i < msgs; i++)
+		sum += (co_await AsyncAwait(*g_roundTripRequest, i)).value_or(0);
+	g_roundTripsDone = sum != 0;
+}
+
+static void StartAwaitRoundTrips(int msgs) { AwaitRoundTrips(msgs); }
+#endif
+
+static void CoroutineBenchmark()
+{
+#if USE_STD_THREADS && defined(__cpp_impl_coroutine)
+	const int MSGS = 20000;
+
+	WorkerThread server("BenchmarkCoroutineServer");
+	WorkerThread client("BenchmarkCoroutineClient");
+	server.CreateThread();
+	client.CreateThread();
+	auto request = MakeDelegate(&RequestFunc, server, WAIT_INFINITE);
+	g_roundTripRequest = &request;
+
+	std::cout << "Coroutine round trips, " << MSGS << " requests" << std::endl;
+	std::cout << std::setw(12) << "mode" << std::setw(14) << "msgs/sec" << std::endl;
+	for (int mode = 0; mode < 2; mode++)
+	{
+		g_roundTripsDone = false;
+		auto start = steady_clock::now();
+		MakeDelegate(mode ? &StartAwaitRoundTrips : &WaitRoundTrips, client)(MSGS);
+		while (!g_roundTripsDone)
+			std::this_thread::yield();
+		duration<double> elapsed = steady_clock::now() - start;
+
+		std::cout << std::setw(12) << (mode ? "co_await" : "wait") << std::fixed << std::setprecision(0)
+			<< std::setw(14) << MSGS / elapsed.count() << std::endl;
+	}
+
+	server.ExitThread();
+	client.ExitThread();
+	g_roundTripRequest = nullptr;
+#endif
+}
+
+//------------------------------------------------------------------------------
+// AsyncWaitLatencyBenchmark
+//------------------------------------------------------------------------------
+// Round trip latency of a blocking AsyncInvoke() to an idle worker thread: the 
+// caller dispatches, the worker wakes and runs the function, then the caller wakes
+// with the return value. Reports the average and percentiles per worker thread type,
+// with the caller parking at once and spinning on the Semaphore first.
+template <class TThread>
+static void AsyncWaitLatency(const char* name, int spin, TThread& thread, int msgs)
+{
+	auto request = MakeDelegate(&RequestFunc, thread, WAIT_INFINITE);
+	std::vector<double> latency;
+	latency.reserve(msgs);
+
+	int sum = 0;
+	auto start = steady_clock::now();
+	for (int i = 0; i < msgs; i++)
+	{
+		auto begin = steady_clock::now();
+		sum += request.AsyncInvoke(i).value_or(0);
+		latency.push_back(duration<double, std::micro>(steady_clock::now() - begin).count());
+	}
+	duration<double, std::micro> elapsed = steady_clock::now() - start;
+	if (sum != msgs * (msgs + 1) / 2)
+		std::cout << "Unexpected result " << sum << std::endl;
+
+	std::sort(latency.begin(), latency.end());
+	std::cout << std::setw(16) << name << std::setw(8) << spin << std::fixed << std::setprecision(2)
+		<< std::setw(12) << elapsed.count() / msgs
+		<< std::setw(12) << latency[latency.size() / 2]
+		<< std::setw(12) << latency[latency.size() * 99 / 100] << std::endl;
+}
+
+static void AsyncWaitLatencyBenchmark()
+{
+#if USE_STD_THREADS
+	const int MSGS = 20000;
+	const int spinCount = Semaphore::GetSpinCount();
+
+	std::cout << "AsyncInvoke round trip to an idle thread (us), " << MSGS << " calls" << std::endl;
+	std::cout << std::setw(16) << "thread" << std::setw(8) << "spin" << std::setw(12) << "avg" << std::setw(12) << "p50" << std::setw(12) << "p99" << std::endl;
+	for (int spin : { 0, spinCount })
+	{
+		Semaphore::SetSpinCount(spin);
+		{
+			WorkerThread thread("BenchmarkWaitThread");
+			thread.CreateThread();
+			AsyncWaitLatency("WorkerThread", spin, thread, MSGS);
+			thread.ExitThread();
+		}
+		{
+			WorkerThreadMpsc thread("BenchmarkWaitMpsc");
+			thread.CreateThread();
+			AsyncWaitLatency("WorkerThreadMpsc", spin, thread, MSGS);
+			thread.ExitThread();
+		}
+	}
+	Semaphore::SetSpinCount(spinCount);
+#endif
+}
+
+//------------------------------------------------------------------------------
+// DelegateBenchmarks
+//------------------------------------------------------------------------------
+void DelegateBenchmarks()
+{
+	DispatchQueueBenchmark();
+	ReceivePathBenchmark();
+	BatchDispatchBenchmark();
+	SpinLatencyBenchmark();
+	TimerJitterBenchmark();
+	MulticastPublishBenchmark();
+	MulticastBroadcastBenchmark();
+	DelegateValueBenchmark();
+	MulticastChurnBenchmark();
+	MulticastFanOutBenchmark();
+	ThreadPoolScalingBenchmark();
+	StrandBenchmark();
+	PriorityLatencyBenchmark();
+	OverflowPolicyBenchmark();
+	ConflationBenchmark();
+	FutureBenchmark();
+	ScatterGatherBenchmark();
+	RequestReplyBenchmark();
+	CoroutineBenchmark();
+	AsyncWaitLatencyBenchmark();
+}
+
+#endif // DELEGATE_BENCHMARKS
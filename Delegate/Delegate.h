@@ -6,6 +6,8 @@
 // David Lafreniere, Oct 2022.
 
 #include <functional>
+#include <cstddef>
+#include <new>
 
 #include "DelegateOpt.h"
 #ifdef USE_XALLOCATOR
@@ -42,8 +44,25 @@ class Delegate<RetType(Args...)> : public DelegateBase {
 public:
     virtual RetType operator()(Args... args) = 0;
     virtual Delegate* Clone() const = 0;
+
+    /// Construct a copy of this instance within caller provided storage using placement
+    /// new. Lets containers hold delegates inline instead of on the heap.
+    /// @param[in] buffer - the storage, aligned to alignof(std::max_align_t).
+    /// @param[in] size - the size of buffer in bytes.
+    /// @return The copy, or nullptr if this instance does not fit within buffer.
+    /// @post The caller is responsible for calling the destructor of the copy.
+    virtual Delegate* CloneTo(void*, size_t) const { return nullptr; }
 };
 
+/// Helper for CloneTo() implementations.
+/// @return A copy of delegate constructed within buffer, or nullptr if it does not fit.
+template <class T>
+T* DelegateCloneTo(const T& delegate, void* buffer, size_t size) {
+    if (sizeof(T) > size || alignof(T) > alignof(std::max_align_t))
+        return nullptr;
+    return new (buffer) T(delegate);
+}
+
 template <class R>
 struct DelegateFree; // Not defined
 
@@ -60,10 +79,11 @@ public:
     void Bind(FreeFunc func) { m_func = func; }
 
     virtual DelegateFree* Clone() const override { return new DelegateFree(*this); }
+    virtual DelegateFree* CloneTo(void* buffer, size_t size) const override { return DelegateCloneTo(*this, buffer, size); }
 
     /// Invoke the bound delegate function. 
     virtual RetType operator()(Args... args) override {
-        return std::invoke(m_func, args...);
+        return std::invoke(m_func, std::forward<Args>(args)...);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
@@ -109,10 +129,11 @@ public:
     }
 
     virtual DelegateMember* Clone() const override { return new DelegateMember(*this); }
+    virtual DelegateMember* CloneTo(void* buffer, size_t size) const override { return DelegateCloneTo(*this, buffer, size); }
 
     // Invoke the bound delegate function
     virtual RetType operator()(Args... args) override {
-        return std::invoke(m_func, m_object, args...);
+        return std::invoke(m_func, m_object, std::forward<Args>(args)...);
     }
 
     virtual bool operator==(const DelegateBase& rhs) const override {
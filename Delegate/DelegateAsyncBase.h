@@ -0,0 +1,279 @@
+#ifndef _DELEGATE_ASYNC_BASE_H
+#define _DELEGATE_ASYNC_BASE_H
+
+// DelegateAsyncBase.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// The dispatch options and message handling shared by the non-blocking asynchronous
+// delegates DelegateFreeAsync<>, DelegateMemberAsync<> and DelegateMemberAsyncSp<>.
+
+#include "Delegate.h"
+#include "IDelegateThread.h"
+#include "DelegateInvoker.h"
+#include "DelegateMsgInline.h"
+#include "DelegateBroadcast.h"
+#include "DelegateConflate.h"
+#include <memory>
+#include <type_traits>
+#include <tuple>
+#include <vector>
+
+namespace DelegateLib {
+
+// std::shared_ptr reference arguments are not allowed with asynchronous delegates as the behavior is
+// undefined. In other words:
+// void MyFunc(std::shared_ptr<T> data)		// Ok!
+// void MyFunc(std::shared_ptr<T>& data)	// Error if DelegateAsync or DelegateSpAsync target!
+template<class T>
+struct is_shared_ptr : std::false_type {};
+
+template<class T>
+struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
+
+template<class T>
+struct is_shared_ptr<std::shared_ptr<T>&> : std::true_type {};
+
+template<class T>
+struct is_shared_ptr<const std::shared_ptr<T>&> : std::true_type {};
+
+template<class T>
+struct is_shared_ptr<std::shared_ptr<T>*> : std::true_type {};
+
+template<class T>
+struct is_shared_ptr<const std::shared_ptr<T>*> : std::true_type {};
+
+/// @brief Base class of the non-blocking asynchronous delegates. Holds the target thread
+/// and the dispatch options, and creates and invokes the messages. The derived class
+/// binds the target function and implements Clone().
+/// @tparam TDerived - the derived asynchronous delegate type.
+/// @tparam TBase - the synchronous delegate type invoked on the target thread (e.g. DelegateFree<>).
+template <class TDerived, class TBase, class... Args>
+class DelegateAsyncBase : public TBase, public IDelegateInvoker, public IDelegateAsync<void(Args...)> {
+public:
+    typedef std::integral_constant<std::size_t, sizeof...(Args)> ArgCnt;
+
+    virtual bool operator==(const DelegateBase& rhs) const override {
+        auto derivedRhs = dynamic_cast<const TDerived*>(&rhs);
+        return derivedRhs &&
+            &m_thread == &derivedRhs->m_thread &&
+            TBase::operator == (rhs);
+    }
+
+    /// Clear the bound target.
+    void Clear() {
+        TBase::Clear();
+        m_target = nullptr;
+    }
+
+    /// Enable or disable the shared target. When enabled, an immutable copy of this delegate
+    /// is created once at bind time and shared by every message in flight. An invocation then
+    /// costs a reference count increment instead of a Clone() heap allocation.
+    /// @param[in] enable - true to share a single target instance.
+    void SetSharedTarget(bool enable) {
+        m_sharedTarget = enable;
+        UpdateSharedTarget();
+    }
+
+    /// @return True if the shared target is enabled.
+    bool GetSharedTarget() const { return m_sharedTarget; }
+
+    /// Enable or disable inline dispatch. When enabled, each invocation copies the bound
+    /// target and the function arguments into a DelegateMsgInline that is moved into the
+    /// target thread's queue. No Clone() or heap message is required.
+    /// @param[in] enable - true to use inline dispatch.
+    void SetInlineDispatch(bool enable) { m_inlineDispatch = enable; }
+
+    /// @return True if inline dispatch is enabled.
+    bool GetInlineDispatch() const { return m_inlineDispatch; }
+
+    /// Set the priority of messages dispatched by this delegate. A DelegatePriorityScope
+    /// on the calling thread overrides it for a single call.
+    /// @param[in] priority - the dispatch priority. Default is NORMAL.
+    void SetPriority(DelegatePriority priority) { m_priority = priority; }
+
+    /// @return The dispatch priority.
+    virtual DelegatePriority GetPriority() const override { return m_priority; }
+
+    /// Set the coalesce key of messages dispatched by this delegate. When the target
+    /// thread's bounded queue is full and uses the COALESCE policy, a new message replaces
+    /// a queued message with the same key. Default is nullptr, never coalesced.
+    /// @param[in] key - any address identifying the message stream, e.g. the target object.
+    void SetCoalesceKey(const void* key) { m_coalesceKey = key; }
+
+    /// @return The coalesce key.
+    virtual const void* GetCoalesceKey() const override { return m_coalesceKey; }
+
+    /// Enable or disable conflation, for "latest value wins" signals. While a message
+    /// dispatched by this delegate or a copy of it is still queued on the target thread,
+    /// a newer invocation replaces the queued arguments instead of dispatching another
+    /// message. The target function then runs once with the latest arguments.
+    /// @param[in] enable - true to conflate invocations.
+    void SetConflate(bool enable) {
+        m_conflate = enable ? std::make_shared<DelegateConflateSlot<Args...>>() : nullptr;
+    }
+
+    /// @return True if conflation is enabled.
+    bool GetConflate() const { return m_conflate != nullptr; }
+
+    /// @return The thread the delegate dispatches to.
+    virtual DelegateThread& GetThread() const override { return m_thread; }
+
+    /// @return A synchronous copy of the bound target. Used by MulticastDelegate<>::Broadcast().
+    ///     nullptr if conflating, as each invocation must pass through this delegate.
+    virtual std::shared_ptr<Delegate<void(Args...)>> GetSyncDelegate() const override {
+        if (m_conflate)
+            return nullptr;
+        return std::make_shared<TBase>(*this);
+    }
+
+    /// Invoke delegate function asynchronously
+    virtual void operator()(Args... args) override {
+        AsyncInvoke(std::forward<Args>(args)...);
+    }
+
+    /// Invoke delegate function asynchronously
+    /// @return True if the target thread queued the message, false if its bounded
+    ///     queue rejected it.
+    bool AsyncInvoke(Args... args) {
+        if (m_conflate)
+            return Conflate(std::forward<Args>(args)...);
+        else if (m_inlineDispatch)
+        {
+            DelegateMsgInline msg(DelegateInlineCall<TBase, Args...>(*this, std::forward<Args>(args)...));
+            msg.SetPriority(DelegatePriorityScope::Resolve(m_priority));
+            msg.SetCoalesceKey(m_coalesceKey);
+            return m_thread.DispatchDelegateInline(std::move(msg));
+        }
+        else
+        {
+            // Share the immutable target, or create a clone instance of this delegate
+            auto delegate = m_target ? m_target : std::shared_ptr<TDerived>(Derived().Clone());
+
+            auto msg = std::make_shared<DelegateMsgHeapArgs<Args...>>(delegate, std::forward<Args>(args)...);
+            msg->SetInvokeFunc(&InvokeTrampoline);
+            msg->SetPriority(DelegatePriorityScope::Resolve(m_priority));
+            msg->SetCoalesceKey(m_coalesceKey);
+
+            static_assert(!((is_shared_ptr<Args>::value && (std::is_lvalue_reference<Args>::value || std::is_pointer<Args>::value)) || ...),
+                "std::shared_ptr reference argument not allowed");
+
+            return m_thread.DispatchDelegate(msg);
+        }
+    }
+
+    /// Invoke the delegate function asynchronously once for each element of calls. All
+    /// invocations are posted to the target thread using a single dispatch operation.
+    /// @param[in] calls - the function arguments of each invocation. Moved into the messages.
+    /// @return The number of invocations the target thread queued.
+    size_t InvokeBatch(std::vector<std::tuple<ArgStorageOf<Args>...>> calls) {
+        if (m_conflate)
+        {
+            // Each call replaces the arguments of the last, so at most one message is queued
+            size_t accepted = 0;
+            for (auto& call : calls)
+            {
+                std::apply([this, &accepted](auto&... args) {
+                    accepted += Conflate(std::forward<Args>(args)...) ? 1 : 0;
+                }, call);
+            }
+            return accepted;
+        }
+        else if (m_inlineDispatch)
+        {
+            const DelegatePriority priority = DelegatePriorityScope::Resolve(m_priority);
+            std::vector<DelegateMsgInline> msgs;
+            msgs.reserve(calls.size());
+            for (auto& call : calls)
+            {
+                std::apply([this, &msgs](auto&... args) {
+                    msgs.emplace_back(DelegateInlineCall<TBase, Args...>(*this, std::forward<Args>(args)...));
+                }, call);
+                msgs.back().SetPriority(priority);
+                msgs.back().SetCoalesceKey(m_coalesceKey);
+            }
+            return m_thread.DispatchDelegateInlineBatch(std::move(msgs));
+        }
+        else
+        {
+            // All messages in the batch share one immutable target
+            auto delegate = m_target ? m_target : std::shared_ptr<TDerived>(Derived().Clone());
+
+            const DelegatePriority priority = DelegatePriorityScope::Resolve(m_priority);
+            std::vector<std::shared_ptr<DelegateMsgBase>> msgs;
+            msgs.reserve(calls.size());
+            for (auto& call : calls)
+            {
+                std::apply([this, &delegate, &msgs, priority](auto&... args) {
+                    auto msg = std::make_shared<DelegateMsgHeapArgs<Args...>>(delegate, std::forward<Args>(args)...);
+                    msg->SetInvokeFunc(&InvokeTrampoline);
+                    msg->SetPriority(priority);
+                    msg->SetCoalesceKey(m_coalesceKey);
+                    msgs.push_back(msg);
+                }, call);
+            }
+            return m_thread.DispatchDelegateBatch(msgs);
+        }
+    }
+
+    /// Called by the target thread to invoke the delegate function
+    virtual void DelegateInvoke(std::shared_ptr<DelegateMsgBase> msg) override {
+        InvokeMsg(*msg);
+    }
+
+    /// Trampoline called by DelegateMsgBase::Invoke() on the target thread. The message
+    /// was created by this class, so its concrete type is known without RTTI.
+    static void InvokeTrampoline(IDelegateInvoker* invoker, DelegateMsgBase& msg) {
+        static_cast<DelegateAsyncBase*>(invoker)->InvokeMsg(msg);
+    }
+
+    /// Invoke the delegate function using the arguments held within msg
+    void InvokeMsg(DelegateMsgBase& msg) {
+        static_cast<DelegateMsgHeapArgs<Args...>&>(msg).Apply([this](auto&&... args) {
+            TBase::operator()(std::forward<decltype(args)>(args)...);
+        });
+    }
+
+protected:
+    /// @param[in] thread - the target thread.
+    /// @param[in] args - the TBase constructor arguments.
+    template <class... TArgs>
+    DelegateAsyncBase(DelegateThread& thread, TArgs&&... args) : TBase(std::forward<TArgs>(args)...), m_thread(thread) {}
+
+    /// Recreate the shared target from the current binding. Called by the derived
+    /// class after binding.
+    void UpdateSharedTarget() {
+        m_target = nullptr;
+        if (m_sharedTarget)
+            m_target = std::shared_ptr<TDerived>(Derived().Clone());
+    }
+
+    /// Target thread to invoke the delegate function
+    DelegateThread& m_thread;
+
+private:
+    const TDerived& Derived() const { return static_cast<const TDerived&>(*this); }
+
+    /// Store the arguments in the conflation slot, and dispatch a message to invoke them
+    /// unless one is already queued. An invocation that replaced the arguments of a
+    /// message the target thread then rejects or discards is lost.
+    bool Conflate(Args... args) {
+        if (m_conflate->Store(std::forward<Args>(args)...))
+            return true;
+
+        DelegateMsgInline msg(DelegateConflateCall<TBase, Args...>(*this, m_conflate));
+        msg.SetPriority(DelegatePriorityScope::Resolve(m_priority));
+        msg.SetCoalesceKey(m_coalesceKey);
+        return m_thread.DispatchDelegateInline(std::move(msg));
+    }
+
+    bool m_inlineDispatch = false;      // Set true to dispatch using DelegateMsgInline
+    bool m_sharedTarget = false;        // Set true to share m_target between invocations
+    std::shared_ptr<TDerived> m_target;     // Immutable target shared by messages in flight
+    DelegatePriority m_priority = DelegatePriority::NORMAL;    // Dispatch priority
+    const void* m_coalesceKey = nullptr;    // Bounded queue COALESCE policy key
+    std::shared_ptr<DelegateConflateSlot<Args...>> m_conflate;    // Pending arguments if conflating
+};
+
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef _DELEGATE_ASYNC_REQUEST_H
+#define _DELEGATE_ASYNC_REQUEST_H
+
+// DelegateAsyncRequest.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Request/response delegates. A request runs the target function on its thread, then
+// invokes a reply delegate with the return value. Bind the reply to an asynchronous
+// delegate so the response is posted back to the caller's thread, letting event driven
+// threads obtain results without ever blocking. If no response arrives in time, a
+// separate timeout delegate is invoked instead.
+
+#include "DelegateAsyncWait.h"
+#include "Timer.h"
+#include <atomic>
+#include <memory>
+
+namespace DelegateLib {
+
+/// @brief Reply state of one request, shared by the request future continuation and the
+/// timeout timer. Whichever completes first invokes its delegate; the other does nothing.
+template <class RetType>
+class DelegateReplyState
+{
+public:
+    using ValueType = typename DelegateFuture<RetType>::ValueType;
+    using ReplyType = std::conditional_t<std::is_void<RetType>::value, Delegate<void()>, Delegate<void(ValueType)>>;
+    using TimeoutType = Delegate<void()>;
+
+    DelegateReplyState(std::shared_ptr<ReplyType> reply, std::shared_ptr<TimeoutType> timeout) :
+        m_reply(std::move(reply)), m_timeoutReply(std::move(timeout))
+    {
+    }
+
+    /// Start the timeout timer, unless already replied.
+    /// @param[in] timeout - time to wait for the response.
+    void StartTimer(std::chrono::milliseconds timeout)
+    {
+        if (m_replied.load())
+            return;
+        m_timer = std::make_unique<Timer>();
+        m_timer->Expired = MakeDelegate(this, &DelegateReplyState::OnTimeout);
+        m_timer->Start(timeout);
+    }
+
+    /// Called with the request result on the target thread, or on the calling thread if
+    /// the request was not dispatched. An empty result invokes the timeout delegate.
+    void Reply(const std::optional<ValueType>& result)
+    {
+        if (m_replied.exchange(true))
+            return;
+        if (!result)
+            (*m_timeoutReply)();
+        else if constexpr (std::is_void<RetType>::value)
+            (*m_reply)();
+        else
+            (*m_reply)(*result);
+    }
+
+private:
+    /// Called on the timer thread if the response did not arrive in time
+    void OnTimeout()
+    {
+        m_timer->Stop();
+        if (!m_replied.exchange(true))
+            (*m_timeoutReply)();
+    }
+
+    std::shared_ptr<ReplyType> m_reply;
+    std::shared_ptr<TimeoutType> m_timeoutReply;
+    std::atomic<bool> m_replied{ false };   // Set by the first of the reply and timeout
+
+    // Destroyed first, so a running OnTimeout() completes before the other members go
+    std::unique_ptr<Timer> m_timer;
+};
+
+template <class R>
+struct DelegateAsyncRequest; // Not defined
+
+/// @brief A non-blocking request/response delegate. Invoking the request dispatches the
+/// target function of an asynchronous wait delegate to its thread and returns at once.
+/// Exactly one of two delegates is then invoked for each request:
+/// - reply, with the target function return value, once the target function runs.
+/// - timeout, if the wait delegate timeout expires first, or the target thread rejects or
+///   discards the request. A late return value is then dropped.
+///
+/// The reply and timeout delegates run where invoked: the target thread, the timer thread
+/// or the calling thread. Bind them to asynchronous delegates, normally targeting the
+/// calling thread, to receive the response on a known thread. The arguments are copied
+/// as DelegateAsync copies them. Copies of a request share the target and reply delegates.
+template <class RetType, class... Args>
+class DelegateAsyncRequest<RetType(Args...)> : public Delegate<void(Args...)> {
+public:
+    using ClassType = DelegateAsyncRequest<RetType(Args...)>;
+    using TargetType = Delegate<RetType(Args...)>;
+    using ReplyType = typename DelegateReplyState<RetType>::ReplyType;
+    using TimeoutType = typename DelegateReplyState<RetType>::TimeoutType;
+
+    /// Constructor
+    /// @param[in] request - a DelegateFreeAsyncWait or DelegateMemberAsyncWait bound to
+    ///     the target function and thread. Its timeout is the time to wait for the reply.
+    /// @param[in] reply - invoked with the target function return value.
+    /// @param[in] timeout - invoked if the reply does not arrive in time.
+    template <class TRequest>
+    DelegateAsyncRequest(const TRequest& request, const ReplyType& reply, const TimeoutType& timeout) :
+        m_reply(reply.Clone()), m_timeoutReply(timeout.Clone()), m_timeout(request.GetTimeout())
+    {
+        auto target = std::shared_ptr<TRequest>(request.Clone());
+        m_target = target;
+        m_invoke = [target](Args... args) { return target->AsyncInvokeFuture(std::forward<Args>(args)...); };
+    }
+    DelegateAsyncRequest() = delete;
+
+    virtual ClassType* Clone() const override {
+        return new ClassType(*this);
+    }
+    virtual ClassType* CloneTo(void* buffer, size_t size) const override {
+        return DelegateCloneTo(*this, buffer, size);
+    }
+
+    virtual bool operator==(const DelegateBase& rhs) const override {
+        auto derivedRhs = dynamic_cast<const ClassType*>(&rhs);
+        return derivedRhs &&
+            *m_target == *derivedRhs->m_target &&
+            *m_reply == *derivedRhs->m_reply &&
+            *m_timeoutReply == *derivedRhs->m_timeoutReply;
+    }
+
+    /// Invoke the request asynchronously
+    virtual void operator()(Args... args) override {
+        AsyncInvoke(std::forward<Args>(args)...);
+    }
+
+    /// Invoke the request asynchronously
+    /// @return False if the target thread rejected the request, in which case the
+    ///     timeout delegate has already been invoked.
+    bool AsyncInvoke(Args... args) {
+        auto state = std::make_shared<DelegateReplyState<RetType>>(m_reply, m_timeoutReply);
+        auto future = m_invoke(std::forward<Args>(args)...);
+        future.Then([state](const std::optional<typename DelegateFuture<RetType>::ValueType>& result) {
+            state->Reply(result);
+        });
+        if (m_timeout != WAIT_INFINITE)
+            state->StartTimer(m_timeout);
+        return !future.IsReady() || future.Get().has_value();
+    }
+
+    /// @return The time to wait for the reply.
+    std::chrono::milliseconds GetTimeout() const { return m_timeout; }
+
+private:
+    std::shared_ptr<TargetType> m_target;           // The wait delegate, used for comparison
+    std::function<DelegateFuture<RetType>(Args...)> m_invoke;   // Calls m_target AsyncInvokeFuture()
+    std::shared_ptr<ReplyType> m_reply;
+    std::shared_ptr<TimeoutType> m_timeoutReply;
+    std::chrono::milliseconds m_timeout;
+};
+
+template <class RetType, class... Args>
+DelegateAsyncRequest<RetType(Args...)> MakeDelegate(const DelegateFreeAsyncWait<RetType(Args...)>& request,
+    const typename DelegateAsyncRequest<RetType(Args...)>::ReplyType& reply, const Delegate<void()>& timeout) {
+    return DelegateAsyncRequest<RetType(Args...)>(request, reply, timeout);
+}
+
+template <class TClass, class RetType, class... Args>
+DelegateAsyncRequest<RetType(Args...)> MakeDelegate(const DelegateMemberAsyncWait<TClass, RetType(Args...)>& request,
+    const typename DelegateAsyncRequest<RetType(Args...)>::ReplyType& reply, const Delegate<void()>& timeout) {
+    return DelegateAsyncRequest<RetType(Args...)>(request, reply, timeout);
+}
+
+}
+
+#endif
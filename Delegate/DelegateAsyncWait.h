@@ -8,6 +8,7 @@
 #include "Delegate.h"
 #include "IDelegateThread.h"
 #include "DelegateInvoker.h"
+#include "DelegateFuture.h"
 #include "Semaphore.h"
 #include <memory>
 #include <chrono>
@@ -31,7 +32,7 @@ class DelegateMemberAsyncWaitInvoke<TClass, void(Args...)> {
 public:
 	void operator()(DelegateMember<TClass, void(Args...)>* instance,
 		Args... args) {
-		(*instance)(args...);
+		(*instance)(std::forward<Args>(args)...);
 	}
 
 	void GetRetVal() { }
@@ -43,7 +44,7 @@ class DelegateMemberAsyncWaitInvoke<TClass, RetType(Args...)> {
 public:
 	void operator()(DelegateMember<TClass, RetType(Args...)>* instance,
 		Args... args) {
-		m_retVal = (*instance)(args...);
+		m_retVal = (*instance)(std::forward<Args>(args)...);
 	}
 
 	RetType GetRetVal() { return m_retVal; }
@@ -60,7 +61,7 @@ class DelegateFreeAsyncWaitInvoke<void(Args...)> {
 public:
 	void operator()(DelegateFree<void(Args...)>* instance,
 		Args... args) {
-		(*instance)(args...);
+		(*instance)(std::forward<Args>(args)...);
 	}
 
 	void GetRetVal() { }
@@ -72,7 +73,7 @@ class DelegateFreeAsyncWaitInvoke<RetType(Args...)> {
 public:
 	void operator()(DelegateFree<RetType(Args...)>* instance,
 		Args... args) {
-		m_retVal = (*instance)(args...);
+		m_retVal = (*instance)(std::forward<Args>(args)...);
 	}
 
 	RetType GetRetVal() { return m_retVal; }
@@ -101,9 +102,19 @@ public:
     }
     DelegateFreeAsyncWait() = delete;
 
+    /// A clone destroyed before invoking its target, e.g. a message discarded by a full
+    /// queue or an exiting thread, fails its future
+    ~DelegateFreeAsyncWait() {
+        if (m_future)
+            m_future->SetFailed();
+    }
+
     virtual ClassType* Clone() const override {
         return new ClassType(*this);
     }
+    virtual ClassType* CloneTo(void* buffer, size_t size) const override {
+        return DelegateCloneTo(*this, buffer, size);
+    }
 
     /// Bind a free function to a delegate. 
     void Bind(FreeFunc func, DelegateThread& thread) {
@@ -129,93 +140,33 @@ public:
     /// Invoke delegate function asynchronously
     virtual RetType operator()(Args... args) override {
         if (m_sync)
-            return BaseType::operator()(args...);
+            return BaseType::operator()(std::forward<Args>(args)...);
         else
         {
             // Create a clone instance of this delegate 
             auto delegate = std::shared_ptr<ClassType>(Clone());
 
-            static_assert(ArgCnt::value <= 5, "Maximum arguments exceeded");
-            if constexpr (ArgCnt::value == 0)
-            {
-                auto msg = std::make_shared<DelegateMsgBase>(delegate);
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 1)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, p1);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 2)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
+            // Take a completion semaphore from this thread's pool
+            delegate->m_sema = SemaphorePool::Acquire();
 
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
+            auto msg = std::make_shared<DelegateMsg<Args...>>(delegate, std::forward<Args>(args)...);
+            msg->SetInvokeFunc(&InvokeTrampoline);
 
-                auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, p1, p2);
+            // The message refers to the caller's arguments, so a queue must not discard it
+            msg->SetDiscardable(false);
 
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 3)
+            // Wait for target thread to execute the delegate target function, unless a 
+            // bounded queue rejected the message
+            m_success = m_thread.DispatchDelegate(msg) && delegate->m_sema->Wait(m_timeout);
+            if (m_success)
             {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, p1, p2, p3);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 4)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-                decltype(auto) p4 = ArgValueOf<3>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-                using Param4 = ArgTypeOf<3, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, p1, p2, p3, p4);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 5)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-                decltype(auto) p4 = ArgValueOf<3>(args...);
-                decltype(auto) p5 = ArgValueOf<4>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-                using Param4 = ArgTypeOf<3, Args...>;
-                using Param5 = ArgTypeOf<4, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, p1, p2, p3, p4, p5);
+                m_invoke = delegate->m_invoke;
 
-                m_thread.DispatchDelegate(msg);
+                // Return the semaphore to this thread's pool. After a timeout the clone
+                // keeps it, since the target thread may still signal it.
+                delegate->m_sema = nullptr;
             }
 
-            // Wait for target thread to execute the delegate target function
-            if ((m_success = delegate->m_sema.Wait(m_timeout)))
-                m_invoke = delegate->m_invoke;
-
             return m_invoke.GetRetVal();
         }
     }
@@ -225,78 +176,71 @@ public:
     {
         if constexpr (std::is_void<RetType>::value == true)
         {
-            operator()(args...);
+            operator()(std::forward<Args>(args)...);
             return IsSuccess() ? std::optional<bool>(true) : std::optional<bool>();
         }
         else
         {
-            auto retVal = operator()(args...);
+            auto retVal = operator()(std::forward<Args>(args)...);
             return IsSuccess() ? std::optional<RetType>(retVal) : std::optional<RetType>();
         }
     }
 
+    /// Invoke delegate function asynchronously without waiting. The arguments are copied
+    /// into the message as DelegateAsync does, so the caller may return immediately and 
+    /// collect the result later. The delegate timeout does not apply; use 
+    /// DelegateFuture::WaitFor() instead. IsSuccess() and GetRetVal() are not updated.
+    /// @return A future completed with the return value once the target thread invokes
+    ///     the function, or with an empty result if the message is rejected or discarded.
+    DelegateFuture<RetType> AsyncInvokeFuture(Args... args) {
+        auto state = std::make_shared<DelegateFutureState<RetType>>();
+
+        // Create a clone instance of this delegate that completes the future
+        auto delegate = std::shared_ptr<ClassType>(Clone());
+        delegate->m_future = state;
+
+        auto msg = std::make_shared<DelegateMsgHeapArgs<Args...>>(delegate, std::forward<Args>(args)...);
+        msg->SetInvokeFunc(&InvokeTrampoline);
+        if (!m_thread.DispatchDelegate(msg))
+            state->SetFailed();
+        return DelegateFuture<RetType>(state);
+    }
+
     /// Called by the target thread to invoke the delegate function 
     virtual void DelegateInvoke(std::shared_ptr<DelegateMsgBase> msg) override {
-        m_sync = true;
+        InvokeMsg(*msg);
+    }
 
-        static_assert(ArgCnt::value <= 5, "Maximum arguments exceeded");
-        if constexpr (ArgCnt::value == 0)
-        {
-            m_invoke(this);
-        }
-        else if constexpr (ArgCnt::value == 1)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg1<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            m_invoke(this, p1);
+    /// Trampoline called by DelegateMsgBase::Invoke() on the target thread. The message
+    /// was created by this class, so its concrete type is known without RTTI.
+    static void InvokeTrampoline(IDelegateInvoker* invoker, DelegateMsgBase& msg) {
+        static_cast<ClassType*>(invoker)->InvokeMsg(msg);
     }
-        else if constexpr (ArgCnt::value == 2)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg2<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            m_invoke(this, p1, p2);
-        }
-        else if constexpr (ArgCnt::value == 3)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg3<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            m_invoke(this, p1, p2, p3);
-        }
-        else if constexpr (ArgCnt::value == 4)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg4<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            auto p4 = delegateMsg->GetParam4();
-            m_invoke(this, p1, p2, p3, p4);
-        }
-        else if constexpr (ArgCnt::value == 5)
+
+    /// Invoke the delegate function using the arguments held within msg
+    void InvokeMsg(DelegateMsgBase& msg) {
+        m_sync = true;
+
+        if (m_future)
         {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg5<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            auto p4 = delegateMsg->GetParam4();
-            auto p5 = delegateMsg->GetParam5();
-            m_invoke(this, p1, p2, p3, p4, p5);
+            static_cast<DelegateMsgHeapArgs<Args...>&>(msg).Apply([this](auto&&... args) {
+                m_invoke(this, std::forward<decltype(args)>(args)...);
+            });
+
+            // Complete the future instead of signaling a waiting thread
+            if constexpr (std::is_void<RetType>::value == true)
+                m_future->SetValue(true);
+            else
+                m_future->SetValue(m_invoke.GetRetVal());
+            return;
         }
 
+        static_cast<DelegateMsg<Args...>&>(msg).Apply([this](auto&&... args) {
+            m_invoke(this, std::forward<decltype(args)>(args)...);
+        });
+
         // Signal the waiting thread
-        m_sema.Signal();
+        m_sema->Signal();
     }
 
     /// Returns true if asynchronous function successfully invoked on target thread
@@ -305,6 +249,12 @@ public:
     /// Returns the async function return value
     RetType GetRetVal() { return m_invoke.GetRetVal(); }
 
+    /// Returns the time to wait for the async function to be invoked
+    std::chrono::milliseconds GetTimeout() const { return m_timeout; }
+
+    /// Returns the thread the delegate dispatches to
+    DelegateThread& GetThread() const { return m_thread; }
+
 private:
     void Swap(const DelegateFreeAsyncWait& s) {
         m_thread = s.m_thread;
@@ -315,9 +265,10 @@ private:
     DelegateThread& m_thread;               // Target thread to invoke the delegate function
     bool m_success = false;			        // Set to true if async function succeeds
     std::chrono::milliseconds m_timeout;    // Time in mS to wait for async function to invoke
-    Semaphore m_sema;				        // Semaphore to signal waiting thread
+    SemaphorePool::Ptr m_sema;              // Semaphore to signal waiting thread, set on a clone invoked by operator()
     bool m_sync = false;                    // Set true when synchronous invocation is required
     DelegateFreeAsyncWaitInvoke<RetType(Args...)> m_invoke;
+    std::shared_ptr<DelegateFutureState<RetType>> m_future;   // Set on a clone invoked by AsyncInvokeFuture()
 };
 
 template <class C, class R>
@@ -347,9 +298,19 @@ public:
     }
     DelegateMemberAsyncWait() = delete;
 
+    /// A clone destroyed before invoking its target, e.g. a message discarded by a full
+    /// queue or an exiting thread, fails its future
+    ~DelegateMemberAsyncWait() {
+        if (m_future)
+            m_future->SetFailed();
+    }
+
     virtual ClassType* Clone() const override {
         return new ClassType(*this);
     }
+    virtual ClassType* CloneTo(void* buffer, size_t size) const override {
+        return DelegateCloneTo(*this, buffer, size);
+    }
 
     /// Bind a member function to a delegate. 
     void Bind(ObjectPtr object, MemberFunc func, DelegateThread& thread) {
@@ -381,93 +342,33 @@ public:
     /// Invoke delegate function asynchronously
     virtual RetType operator()(Args... args) override {
         if (m_sync)
-            return BaseType::operator()(args...);
+            return BaseType::operator()(std::forward<Args>(args)...);
         else
         {
             // Create a clone instance of this delegate 
             auto delegate = std::shared_ptr<ClassType>(Clone());
 
-            static_assert(ArgCnt::value <= 5, "Maximum arguments exceeded");
-            if constexpr (ArgCnt::value == 0)
-            {
-                auto msg = std::make_shared<DelegateMsgBase>(delegate);
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 1)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg1<Param1>>(delegate, p1);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 2)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
+            // Take a completion semaphore from this thread's pool
+            delegate->m_sema = SemaphorePool::Acquire();
 
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
+            auto msg = std::make_shared<DelegateMsg<Args...>>(delegate, std::forward<Args>(args)...);
+            msg->SetInvokeFunc(&InvokeTrampoline);
 
-                auto msg = std::make_shared<DelegateMsg2<Param1, Param2>>(delegate, p1, p2);
+            // The message refers to the caller's arguments, so a queue must not discard it
+            msg->SetDiscardable(false);
 
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 3)
+            // Wait for target thread to execute the delegate target function, unless a 
+            // bounded queue rejected the message
+            m_success = m_thread.DispatchDelegate(msg) && delegate->m_sema->Wait(m_timeout);
+            if (m_success)
             {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg3<Param1, Param2, Param3>>(delegate, p1, p2, p3);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 4)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-                decltype(auto) p4 = ArgValueOf<3>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-                using Param4 = ArgTypeOf<3, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg4<Param1, Param2, Param3, Param4>>(delegate, p1, p2, p3, p4);
-
-                m_thread.DispatchDelegate(msg);
-            }
-            else if constexpr (ArgCnt::value == 5)
-            {
-                decltype(auto) p1 = ArgValueOf<0>(args...);
-                decltype(auto) p2 = ArgValueOf<1>(args...);
-                decltype(auto) p3 = ArgValueOf<2>(args...);
-                decltype(auto) p4 = ArgValueOf<3>(args...);
-                decltype(auto) p5 = ArgValueOf<4>(args...);
-
-                using Param1 = ArgTypeOf<0, Args...>;
-                using Param2 = ArgTypeOf<1, Args...>;
-                using Param3 = ArgTypeOf<2, Args...>;
-                using Param4 = ArgTypeOf<3, Args...>;
-                using Param5 = ArgTypeOf<4, Args...>;
-
-                auto msg = std::make_shared<DelegateMsg5<Param1, Param2, Param3, Param4, Param5>>(delegate, p1, p2, p3, p4, p5);
+                m_invoke = delegate->m_invoke;
 
-                m_thread.DispatchDelegate(msg);
+                // Return the semaphore to this thread's pool. After a timeout the clone
+                // keeps it, since the target thread may still signal it.
+                delegate->m_sema = nullptr;
             }
 
-            // Wait for target thread to execute the delegate target function
-            if ((m_success = delegate->m_sema.Wait(m_timeout)))
-                m_invoke = delegate->m_invoke;
-
             return m_invoke.GetRetVal();
         }
     }
@@ -477,78 +378,71 @@ public:
     {
         if constexpr (std::is_void<RetType>::value == true)
         {
-            operator()(args...);
+            operator()(std::forward<Args>(args)...);
             return IsSuccess() ? std::optional<bool>(true) : std::optional<bool>();
         }
         else
         {
-            auto retVal = operator()(args...);
+            auto retVal = operator()(std::forward<Args>(args)...);
             return IsSuccess() ? std::optional<RetType>(retVal) : std::optional<RetType>();
         }
     }
 
+    /// Invoke delegate function asynchronously without waiting. The arguments are copied
+    /// into the message as DelegateAsync does, so the caller may return immediately and 
+    /// collect the result later. The delegate timeout does not apply; use 
+    /// DelegateFuture::WaitFor() instead. IsSuccess() and GetRetVal() are not updated.
+    /// @return A future completed with the return value once the target thread invokes
+    ///     the function, or with an empty result if the message is rejected or discarded.
+    DelegateFuture<RetType> AsyncInvokeFuture(Args... args) {
+        auto state = std::make_shared<DelegateFutureState<RetType>>();
+
+        // Create a clone instance of this delegate that completes the future
+        auto delegate = std::shared_ptr<ClassType>(Clone());
+        delegate->m_future = state;
+
+        auto msg = std::make_shared<DelegateMsgHeapArgs<Args...>>(delegate, std::forward<Args>(args)...);
+        msg->SetInvokeFunc(&InvokeTrampoline);
+        if (!m_thread.DispatchDelegate(msg))
+            state->SetFailed();
+        return DelegateFuture<RetType>(state);
+    }
+
     /// Called by the target thread to invoke the delegate function 
     virtual void DelegateInvoke(std::shared_ptr<DelegateMsgBase> msg) override {
-        m_sync = true;
+        InvokeMsg(*msg);
+    }
 
-        static_assert(ArgCnt::value <= 5, "Maximum arguments exceeded");
-        if constexpr (ArgCnt::value == 0)
-        {
-            m_invoke(this);
-        }
-        else if constexpr (ArgCnt::value == 1)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg1<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            m_invoke(this, p1);
+    /// Trampoline called by DelegateMsgBase::Invoke() on the target thread. The message
+    /// was created by this class, so its concrete type is known without RTTI.
+    static void InvokeTrampoline(IDelegateInvoker* invoker, DelegateMsgBase& msg) {
+        static_cast<ClassType*>(invoker)->InvokeMsg(msg);
     }
-        else if constexpr (ArgCnt::value == 2)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg2<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            m_invoke(this, p1, p2);
-        }
-        else if constexpr (ArgCnt::value == 3)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg3<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            m_invoke(this, p1, p2, p3);
-        }
-        else if constexpr (ArgCnt::value == 4)
-        {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg4<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            auto p4 = delegateMsg->GetParam4();
-            m_invoke(this, p1, p2, p3, p4);
-        }
-        else if constexpr (ArgCnt::value == 5)
+
+    /// Invoke the delegate function using the arguments held within msg
+    void InvokeMsg(DelegateMsgBase& msg) {
+        m_sync = true;
+
+        if (m_future)
         {
-            auto delegateMsg = std::dynamic_pointer_cast<DelegateMsg5<Args...>>(msg);
-            if (delegateMsg == nullptr)
-                throw std::invalid_argument("Invalid std::dynamic_pointer_cast");
-            auto p1 = delegateMsg->GetParam1();
-            auto p2 = delegateMsg->GetParam2();
-            auto p3 = delegateMsg->GetParam3();
-            auto p4 = delegateMsg->GetParam4();
-            auto p5 = delegateMsg->GetParam5();
-            m_invoke(this, p1, p2, p3, p4, p5);
+            static_cast<DelegateMsgHeapArgs<Args...>&>(msg).Apply([this](auto&&... args) {
+                m_invoke(this, std::forward<decltype(args)>(args)...);
+            });
+
+            // Complete the future instead of signaling a waiting thread
+            if constexpr (std::is_void<RetType>::value == true)
+                m_future->SetValue(true);
+            else
+                m_future->SetValue(m_invoke.GetRetVal());
+            return;
         }
 
+        static_cast<DelegateMsg<Args...>&>(msg).Apply([this](auto&&... args) {
+            m_invoke(this, std::forward<decltype(args)>(args)...);
+        });
+
         // Signal the waiting thread
-        m_sema.Signal();
+        m_sema->Signal();
     }
 
     /// Returns true if asynchronous function successfully invoked on target thread
@@ -557,6 +451,12 @@ public:
     /// Returns the async function return value
     RetType GetRetVal() { return m_invoke.GetRetVal(); }
 
+    /// Returns the time to wait for the async function to be invoked
+    std::chrono::milliseconds GetTimeout() const { return m_timeout; }
+
+    /// Returns the thread the delegate dispatches to
+    DelegateThread& GetThread() const { return m_thread; }
+
 private:
     void Swap(const DelegateMemberAsyncWait& s) {
         m_thread = s.m_thread;
@@ -567,9 +467,10 @@ private:
     DelegateThread& m_thread;	            // Target thread to invoke the delegate function
     bool m_success = false;					// Set to true if async function succeeds
     std::chrono::milliseconds m_timeout;    // Time in mS to wait for async function to invoke
-    Semaphore m_sema;				        // Semaphore to signal waiting thread
+    SemaphorePool::Ptr m_sema;              // Semaphore to signal waiting thread, set on a clone invoked by operator()
     bool m_sync = false;                    // Set true when synchronous invocation is required
     DelegateMemberAsyncWaitInvoke<TClass, RetType(Args...)> m_invoke;
+    std::shared_ptr<DelegateFutureState<RetType>> m_future;   // Set on a clone invoked by AsyncInvokeFuture()
 };
 
 template <class TClass, class RetType, class... Args>
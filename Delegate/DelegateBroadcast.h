@@ -0,0 +1,116 @@
+#ifndef _DELEGATE_BROADCAST_H
+#define _DELEGATE_BROADCAST_H
+
+// DelegateBroadcast.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Support for MulticastDelegate<>::Broadcast(). The function arguments are copied once
+// into an immutable payload shared by every asynchronous subscriber, and each target
+// thread receives one message per broadcast invoking all of its subscribers in turn.
+
+#include "Delegate.h"
+#include "IDelegateThread.h"
+#include "DelegatePriority.h"
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace DelegateLib {
+
+template <class R>
+class IDelegateAsync; // Not defined
+
+/// @brief Interface implemented by the non-blocking asynchronous delegates. Allows a
+/// multicast container to group its subscribers by target thread and priority.
+template <class... Args>
+class IDelegateAsync<void(Args...)>
+{
+public:
+    /// @return The thread the delegate dispatches to.
+    virtual DelegateThread& GetThread() const = 0;
+
+    /// @return The priority of the messages the delegate dispatches.
+    virtual DelegatePriority GetPriority() const = 0;
+
+    /// @return The coalesce key of the messages the delegate dispatches, or nullptr.
+    virtual const void* GetCoalesceKey() const = 0;
+
+    /// @return A synchronous copy of the bound target, invoked on the target thread, or
+    ///     nullptr if each invocation must be dispatched through the delegate itself.
+    virtual std::shared_ptr<Delegate<void(Args...)>> GetSyncDelegate() const = 0;
+
+protected:
+    virtual ~IDelegateAsync() = default;
+};
+
+/// True if Param may be read by several threads from one shared copy: passed by value
+/// and copyable, or passed by const reference or pointer to const.
+template <class Param>
+struct is_broadcast_arg : std::bool_constant<
+    (!std::is_reference<Param>::value && !std::is_pointer<Param>::value && std::is_copy_constructible<Param>::value) ||
+    (std::is_lvalue_reference<Param>::value && std::is_const<std::remove_reference_t<Param>>::value) ||
+    (std::is_pointer<Param>::value && std::is_const<std::remove_pointer_t<Param>>::value &&
+        !std::is_pointer<std::remove_const_t<std::remove_pointer_t<Param>>>::value)> {};
+
+/// @brief Storage for one function argument within a broadcast payload. Holds a copy
+/// of the value, referenced object or pointee.
+template <class Param>
+class BroadcastArg
+{
+public:
+    explicit BroadcastArg(const Param& param) : m_param(param) {}
+    const Param& Get() const { return m_param; }
+private:
+    Param m_param;
+};
+
+template <class Param>
+class BroadcastArg<const Param&>
+{
+public:
+    explicit BroadcastArg(const Param& param) : m_param(param) {}
+    const Param& Get() const { return m_param; }
+private:
+    Param m_param;
+};
+
+template <class Param>
+class BroadcastArg<const Param*>
+{
+public:
+    explicit BroadcastArg(const Param* param) : m_param(*param) {}
+    const Param* Get() const { return &m_param; }
+private:
+    Param m_param;
+};
+
+/// @brief The callable a broadcast places within a DelegateMsgInline for one target
+/// thread. Invokes each subscriber of that thread with the shared payload.
+template <class... Args>
+class DelegateBroadcastCall
+{
+public:
+    typedef std::vector<std::shared_ptr<Delegate<void(Args...)>>> TargetList;
+    typedef std::tuple<BroadcastArg<Args>...> Payload;
+
+    DelegateBroadcastCall(std::shared_ptr<const TargetList> targets, std::shared_ptr<const Payload> payload) :
+        m_targets(std::move(targets)), m_payload(std::move(payload))
+    {
+    }
+
+    /// Invoke the subscribers on the destination thread
+    void operator()()
+    {
+        for (auto& target : *m_targets)
+            std::apply([&target](auto&... args) { (*target)(args.Get()...); }, *m_payload);
+    }
+
+private:
+    std::shared_ptr<const TargetList> m_targets;
+    std::shared_ptr<const Payload> m_payload;
+};
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef _DELEGATE_CONFLATE_H
+#define _DELEGATE_CONFLATE_H
+
+// DelegateConflate.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Conflating dispatch for "latest value wins" asynchronous delegates. While an invocation
+// is queued on the target thread, newer invocations overwrite its arguments instead of
+// queuing more messages, so a consumer that falls behind only sees the latest value.
+
+#include "DelegateMsgInline.h"
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace DelegateLib {
+
+/// @brief The pending arguments of a conflating delegate, shared by the delegate, its
+/// copies and the message queued on the target thread. Arguments are held while a
+/// message is queued and taken when the message is invoked.
+template <class... Args>
+class DelegateConflateSlot
+{
+public:
+    /// Store the arguments of a new invocation, replacing any pending arguments.
+    /// @param[in] args - the function arguments.
+    /// @return True if a queued message will invoke the arguments. False if the caller
+    ///     must dispatch a message that calls Invoke().
+    bool Store(Args... args) {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        const bool queued = m_args.has_value();
+        m_args.emplace(DelegateArg<ArgStorageOf<Args>>(std::forward<Args>(args))...);
+        return queued;
+    }
+
+    /// Discard the pending arguments after the target thread rejected the message.
+    void Cancel() {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        m_args.reset();
+    }
+
+    /// Take the pending arguments and invoke target with them. Called once per
+    /// message on the target thread. A later Store() then dispatches a new message.
+    /// @param[in] target - the synchronous delegate to invoke.
+    template <class TDelegate>
+    void Invoke(TDelegate& target) {
+        std::optional<Arguments> args;
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            if (m_args)
+            {
+                args.emplace(std::move(*m_args));
+                m_args.reset();
+            }
+        }
+        if (args)
+            std::apply([&target](auto&... arg) { target(arg.Get()...); }, *args);
+    }
+
+private:
+    using Arguments = std::tuple<DelegateArg<ArgStorageOf<Args>>...>;
+
+    std::mutex m_lock;
+    std::optional<Arguments> m_args;    // Set while a message is queued
+};
+
+/// @brief The callable a conflating delegate places within a DelegateMsgInline. Invokes
+/// the latest pending arguments. If a queue discards the message without invoking it,
+/// the pending arguments are discarded too, so the next invocation dispatches anew.
+/// @tparam TDelegate - the synchronous delegate type (e.g. DelegateFree<>).
+template <class TDelegate, class... Args>
+class DelegateConflateCall
+{
+public:
+    DelegateConflateCall(const TDelegate& delegate, std::shared_ptr<DelegateConflateSlot<Args...>> slot) :
+        m_delegate(delegate), m_slot(std::move(slot))
+    {
+    }
+
+    DelegateConflateCall(DelegateConflateCall&&) noexcept = default;
+
+    ~DelegateConflateCall()
+    {
+        if (m_slot)
+            m_slot->Cancel();
+    }
+
+    /// Invoke the target function on the destination thread
+    void operator()()
+    {
+        auto slot = std::move(m_slot);
+        slot->Invoke(m_delegate);
+    }
+
+private:
+    TDelegate m_delegate;
+    std::shared_ptr<DelegateConflateSlot<Args...>> m_slot;     // nullptr once invoked or moved
+};
+
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef _DELEGATE_CONNECTION_H
+#define _DELEGATE_CONNECTION_H
+
+// DelegateConnection.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Subscription handles returned when a delegate is added to a multicast delegate
+// container. A handle removes its delegate without comparing delegates, and remains
+// safe to use after the container is destroyed.
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace DelegateLib {
+
+/// @brief Interface a delegate container implements to support DelegateConnection.
+class IDelegateConnectionList
+{
+public:
+    /// Remove the delegate added with id, if still present.
+    virtual void Disconnect(uint64_t id) = 0;
+
+    /// @return True if the delegate added with id is still present.
+    virtual bool IsConnected(uint64_t id) = 0;
+
+protected:
+    virtual ~IDelegateConnectionList() = default;
+};
+
+/// @brief Shared between a container and its connections. The container detaches
+/// itself on destruction so outstanding connections become no-ops.
+struct DelegateConnectionAnchor
+{
+    explicit DelegateConnectionAnchor(IDelegateConnectionList* list) : list(list) {}
+
+    /// Call func with the container unless it was detached. The lock is not held
+    /// during the call, so a thread-safe container may take its own lock without
+    /// ordering it against this one.
+    /// @return The result of func, or fallback if the container was detached.
+    template <class Func, class Result>
+    Result Call(Func func, Result fallback) {
+        IDelegateConnectionList* container;
+        {
+            const std::lock_guard<std::mutex> lk(lock);
+            if (!list)
+                return fallback;
+            container = list;
+            users++;
+        }
+        const Result result = func(container);
+        const std::lock_guard<std::mutex> lk(lock);
+        if (--users == 0)
+            idle.notify_all();
+        return result;
+    }
+
+    /// Detach the container, waiting for calls in progress on other threads.
+    void Detach() {
+        std::unique_lock<std::mutex> lk(lock);
+        list = nullptr;
+        while (users != 0)
+            idle.wait(lk);
+    }
+
+    std::mutex lock;
+    std::condition_variable idle;
+    IDelegateConnectionList* list;
+    int users = 0;
+};
+
+/// @brief A handle to one delegate added to a multicast delegate container. Copyable;
+/// all copies refer to the same subscription. Destroying a DelegateConnection does not
+/// remove the delegate; use ScopedConnection for that. A callback may disconnect or
+/// query its connection to the container invoking it. Calling Disconnect() or
+/// Connected() from another thread requires a MulticastDelegateSafe container.
+class DelegateConnection
+{
+public:
+    DelegateConnection() = default;
+    DelegateConnection(std::shared_ptr<DelegateConnectionAnchor> anchor, uint64_t id) :
+        m_anchor(std::move(anchor)), m_id(id) {}
+
+    /// Remove the delegate from its container. Does nothing if already removed or if
+    /// the container was destroyed.
+    void Disconnect() {
+        if (m_anchor)
+            m_anchor->Call([this](IDelegateConnectionList* list) { list->Disconnect(m_id); return true; }, false);
+        m_anchor = nullptr;
+    }
+
+    /// @return True if the delegate is still within its container.
+    bool Connected() const {
+        if (!m_anchor)
+            return false;
+        return m_anchor->Call([this](IDelegateConnectionList* list) { return list->IsConnected(m_id); }, false);
+    }
+
+    explicit operator bool() const { return Connected(); }
+
+private:
+    std::shared_ptr<DelegateConnectionAnchor> m_anchor;
+    uint64_t m_id = 0;
+};
+
+/// @brief A move-only DelegateConnection that removes its delegate when destroyed.
+class ScopedConnection
+{
+public:
+    ScopedConnection() = default;
+    ScopedConnection(const DelegateConnection& connection) : m_connection(connection) {}
+    ScopedConnection(ScopedConnection&& rhs) noexcept : m_connection(std::move(rhs.m_connection)) {
+        rhs.m_connection = DelegateConnection();
+    }
+    ScopedConnection& operator=(ScopedConnection&& rhs) noexcept {
+        if (&rhs != this)
+        {
+            m_connection.Disconnect();
+            m_connection = std::move(rhs.m_connection);
+            rhs.m_connection = DelegateConnection();
+        }
+        return *this;
+    }
+    ScopedConnection& operator=(const DelegateConnection& connection) {
+        m_connection.Disconnect();
+        m_connection = connection;
+        return *this;
+    }
+    ~ScopedConnection() { m_connection.Disconnect(); }
+
+    /// Remove the delegate from its container now.
+    void Disconnect() { m_connection.Disconnect(); }
+
+    /// Give up ownership without removing the delegate.
+    /// @return The connection.
+    DelegateConnection Release() {
+        DelegateConnection connection = m_connection;
+        m_connection = DelegateConnection();
+        return connection;
+    }
+
+    /// @return True if the delegate is still within its container.
+    bool Connected() const { return m_connection.Connected(); }
+
+    explicit operator bool() const { return Connected(); }
+
+private:
+    ScopedConnection(const ScopedConnection&) = delete;
+    ScopedConnection& operator=(const ScopedConnection&) = delete;
+
+    DelegateConnection m_connection;
+};
+
+}
+
+#endif
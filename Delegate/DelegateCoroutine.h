@@ -0,0 +1,218 @@
+#ifndef _DELEGATE_COROUTINE_H
+#define _DELEGATE_COROUTINE_H
+
+// DelegateCoroutine.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Opt-in C++20 coroutine support. AsyncAwait() makes an asynchronous delegate invocation
+// awaitable: co_await suspends the coroutine, the target function runs on the delegate
+// thread, and the coroutine resumes on its original DelegateThread with the return value.
+// No thread blocks, and a typical await requires no heap allocation. Compiles to nothing
+// unless the compiler implements coroutines.
+
+#include "DelegateOpt.h"
+
+#if defined(__cpp_impl_coroutine)
+
+#include "DelegateAsync.h"
+#include "DelegateAsyncWait.h"
+#include "DelegateSpAsync.h"
+#include <coroutine>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace DelegateLib {
+
+/// Resume a coroutine on thread. Resumes on the calling thread if thread is nullptr,
+/// e.g. a coroutine started outside of any DelegateThread, or if thread rejects the message.
+/// @param[in] handle - the suspended coroutine.
+/// @param[in] thread - the thread to resume on, or nullptr.
+inline void DelegateResume(std::coroutine_handle<> handle, DelegateThread* thread)
+{
+    if (thread)
+    {
+        DelegateMsgInline msg([handle]() { handle.resume(); });
+        msg.SetDiscardable(false);
+        if (thread->DispatchDelegateInline(std::move(msg)))
+            return;
+    }
+    handle.resume();
+}
+
+/// @brief The awaitable returned by AsyncAwait(). Lives within the coroutine frame, so
+/// the function arguments and the result are held in place: reference arguments refer to
+/// the caller's objects, as with the blocking wait delegates, and the message dispatched
+/// to the target thread only holds a pointer to this instance.
+/// @tparam TTarget - the synchronous delegate type (e.g. DelegateFree<>).
+template <class TTarget, class RetType, class... Args>
+class DelegateAwaitable
+{
+public:
+    /// The result type. A void function completes with true, matching AsyncInvoke().
+    using ValueType = std::conditional_t<std::is_void<RetType>::value, bool, RetType>;
+
+    template <class... Ts>
+    DelegateAwaitable(const TTarget& target, DelegateThread& thread, DelegatePriority priority, Ts&&... args) :
+        m_target(target), m_thread(thread), m_priority(priority), m_args(std::forward<Ts>(args)...)
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    /// Dispatch the target function to the delegate thread.
+    /// @return False to resume at once with an empty result if the thread rejected it.
+    bool await_suspend(std::coroutine_handle<> handle)
+    {
+        DelegateMsgInline msg(Call(this, handle, DelegateThreadScope::GetCurrent()));
+        msg.SetPriority(m_priority);
+
+        // Once accepted the coroutine may resume on another thread at any moment, so
+        // this instance must not be touched after the dispatch returns
+        DelegateThread& thread = m_thread;
+        Dispatching() = this;
+        const bool accepted = thread.DispatchDelegateInline(std::move(msg));
+        Dispatching() = nullptr;
+        return accepted;
+    }
+
+    /// @return The target function return value (true for a void function), or an
+    ///     empty optional if the thread rejected or discarded the message.
+    std::optional<ValueType> await_resume() { return std::move(m_result); }
+
+private:
+    DelegateAwaitable(const DelegateAwaitable&) = delete;
+    DelegateAwaitable& operator=(const DelegateAwaitable&) = delete;
+
+    /// The callable dispatched to the target thread. Invokes the target function, then
+    /// resumes the coroutine. A message destroyed without being invoked, e.g. discarded
+    /// by a full bounded queue, resumes the coroutine with an empty result.
+    class Call
+    {
+    public:
+        Call(DelegateAwaitable* awaitable, std::coroutine_handle<> handle, DelegateThread* resume) :
+            m_awaitable(awaitable), m_handle(handle), m_resume(resume)
+        {
+        }
+
+        Call(Call&& rhs) noexcept :
+            m_awaitable(std::exchange(rhs.m_awaitable, nullptr)), m_handle(rhs.m_handle), m_resume(rhs.m_resume)
+        {
+        }
+
+        ~Call()
+        {
+            // A rejected dispatch resumes through await_suspend() instead
+            if (m_awaitable && Dispatching() != m_awaitable)
+                Resume();
+        }
+
+        /// Invoke the target function on the destination thread
+        void operator()()
+        {
+            m_awaitable->Invoke();
+            Resume();
+        }
+
+    private:
+        void Resume()
+        {
+            m_awaitable = nullptr;
+            DelegateResume(m_handle, m_resume);
+        }
+
+        DelegateAwaitable* m_awaitable;     // nullptr once resumed or moved
+        std::coroutine_handle<> m_handle;
+        DelegateThread* m_resume;           // Thread to resume on, or nullptr
+    };
+
+    /// Invoke the target function with the stored arguments
+    void Invoke()
+    {
+        std::apply([this](auto&... args) {
+            if constexpr (std::is_void<RetType>::value)
+            {
+                m_target(TakeArg<Args>(args)...);
+                m_result = true;
+            }
+            else
+                m_result = m_target(TakeArg<Args>(args)...);
+        }, m_args);
+    }
+
+    template <typename Arg, typename T>
+    static decltype(auto) TakeArg(T& arg)
+    {
+        if constexpr (std::is_lvalue_reference<Arg>::value)
+            return static_cast<T&>(arg);
+        else
+            return std::move(arg);
+    }
+
+    /// The awaitable the calling thread is dispatching, to tell a rejected message from
+    /// a discarded one
+    static const void*& Dispatching()
+    {
+        thread_local const void* dispatching = nullptr;
+        return dispatching;
+    }
+
+    TTarget m_target;
+    DelegateThread& m_thread;
+    DelegatePriority m_priority;
+    std::tuple<ArgStorageOf<Args>...> m_args;
+    std::optional<ValueType> m_result;
+};
+
+/// Await an asynchronous delegate invocation within a coroutine. The target function runs
+/// on the delegate thread, then the coroutine resumes on the DelegateThread it was running
+/// on, or on the target thread if none. A coroutine running on a WorkerStrand resumes on
+/// the strand's executor.
+/// @code
+/// std::optional<bool> done = co_await AsyncAwait(MakeDelegate(&Func, workerThread), 123);
+/// @endcode
+template <class... Args>
+DelegateAwaitable<DelegateFree<void(Args...)>, void, Args...> AsyncAwait(
+    const DelegateFreeAsync<void(Args...)>& delegate, std::type_identity_t<Args>... args) {
+    return DelegateAwaitable<DelegateFree<void(Args...)>, void, Args...>(delegate, delegate.GetThread(),
+        DelegatePriorityScope::Resolve(delegate.GetPriority()), std::forward<Args>(args)...);
+}
+
+template <class TClass, class... Args>
+DelegateAwaitable<DelegateMember<TClass, void(Args...)>, void, Args...> AsyncAwait(
+    const DelegateMemberAsync<TClass, void(Args...)>& delegate, std::type_identity_t<Args>... args) {
+    return DelegateAwaitable<DelegateMember<TClass, void(Args...)>, void, Args...>(delegate, delegate.GetThread(),
+        DelegatePriorityScope::Resolve(delegate.GetPriority()), std::forward<Args>(args)...);
+}
+
+template <class TClass, class... Args>
+DelegateAwaitable<DelegateMemberSp<TClass, void(Args...)>, void, Args...> AsyncAwait(
+    const DelegateMemberAsyncSp<TClass, void(Args...)>& delegate, std::type_identity_t<Args>... args) {
+    return DelegateAwaitable<DelegateMemberSp<TClass, void(Args...)>, void, Args...>(delegate, delegate.GetThread(),
+        DelegatePriorityScope::Resolve(delegate.GetPriority()), std::forward<Args>(args)...);
+}
+
+/// Await a function with a return value. The wait delegate timeout does not apply.
+/// @code
+/// std::optional<int> value = co_await AsyncAwait(MakeDelegate(&Func, workerThread, WAIT_INFINITE), 123);
+/// @endcode
+template <class RetType, class... Args>
+DelegateAwaitable<DelegateFree<RetType(Args...)>, RetType, Args...> AsyncAwait(
+    const DelegateFreeAsyncWait<RetType(Args...)>& delegate, std::type_identity_t<Args>... args) {
+    return DelegateAwaitable<DelegateFree<RetType(Args...)>, RetType, Args...>(delegate, delegate.GetThread(),
+        DelegatePriorityScope::Resolve(DelegatePriority::NORMAL), std::forward<Args>(args)...);
+}
+
+template <class TClass, class RetType, class... Args>
+DelegateAwaitable<DelegateMember<TClass, RetType(Args...)>, RetType, Args...> AsyncAwait(
+    const DelegateMemberAsyncWait<TClass, RetType(Args...)>& delegate, std::type_identity_t<Args>... args) {
+    return DelegateAwaitable<DelegateMember<TClass, RetType(Args...)>, RetType, Args...>(delegate, delegate.GetThread(),
+        DelegatePriorityScope::Resolve(DelegatePriority::NORMAL), std::forward<Args>(args)...);
+}
+
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif
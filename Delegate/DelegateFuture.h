@@ -0,0 +1,262 @@
+#ifndef _DELEGATE_FUTURE_H
+#define _DELEGATE_FUTURE_H
+
+// DelegateFuture.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// The result of a non-blocking asynchronous wait delegate invocation. The caller returns
+// immediately and later polls, waits for or attaches a continuation to the result, so
+// requests to several threads overlap instead of paying one round trip each. WhenAll()
+// and WhenAny() gather the results of many invocations under a single timeout.
+
+#include "Fault.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace DelegateLib {
+
+#undef max
+
+/// Convert a timeout to a steady clock deadline.
+/// @param[in] timeout - the timeout. milliseconds::max() never expires.
+/// @return The deadline, or time_point::max() if the timeout never expires.
+inline std::chrono::steady_clock::time_point DelegateDeadline(std::chrono::milliseconds timeout)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (timeout >= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::time_point::max() - now))
+        return std::chrono::steady_clock::time_point::max();
+    return now + timeout;
+}
+
+/// @brief The completion state shared by a DelegateFuture and the delegate clone that
+/// invokes the target function. Completed once, either with the return value or as failed.
+template <class RetType>
+class DelegateFutureState
+{
+public:
+    /// The result type. A void function completes with true, matching AsyncInvoke().
+    using ValueType = std::conditional_t<std::is_void<RetType>::value, bool, RetType>;
+    using Continuation = std::function<void(std::optional<ValueType>)>;
+
+    /// Complete with the target function return value. Called on the target thread.
+    void SetValue(ValueType value) { Complete(std::optional<ValueType>(std::move(value))); }
+
+    /// Complete without a value because the message was rejected or discarded. Ignored
+    /// if already complete.
+    void SetFailed() { Complete(std::nullopt); }
+
+    /// @return True once complete.
+    bool IsReady() const { return m_ready.load(std::memory_order_acquire); }
+
+    /// Wait for completion or a deadline.
+    /// @param[in] deadline - time to stop waiting. time_point::max() waits forever.
+    /// @return True if complete, false if the deadline passed.
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline)
+    {
+        if (IsReady())
+            return true;
+        std::unique_lock<std::mutex> lk(m_lock);
+        if (deadline == std::chrono::steady_clock::time_point::max())
+        {
+            m_cv.wait(lk, [this] { return IsReady(); });
+            return true;
+        }
+        return m_cv.wait_until(lk, deadline, [this] { return IsReady(); });
+    }
+
+    /// @return The result. Only read once IsReady() returns true, after which the
+    /// result no longer changes.
+    const std::optional<ValueType>& GetResult() const { return m_result; }
+
+    /// Add a function called with the result on completion. Called immediately on the
+    /// calling thread if already complete, otherwise on the thread that completes the 
+    /// state, in the order added.
+    /// @param[in] func - the continuation.
+    void Then(Continuation func)
+    {
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            if (!IsReady())
+            {
+                m_continuations.push_back(std::move(func));
+                return;
+            }
+        }
+        func(m_result);
+    }
+
+private:
+    void Complete(std::optional<ValueType> result)
+    {
+        std::vector<Continuation> continuations;
+        {
+            const std::lock_guard<std::mutex> lock(m_lock);
+            if (IsReady())
+                return;
+            m_result = std::move(result);
+            m_ready.store(true, std::memory_order_release);
+            continuations.swap(m_continuations);
+        }
+        m_cv.notify_all();
+        for (auto& continuation : continuations)
+            continuation(m_result);
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_cv;
+    std::atomic<bool> m_ready{ false };
+    std::optional<ValueType> m_result;      // Empty if the invocation failed
+    std::vector<Continuation> m_continuations;
+};
+
+/// @brief A lightweight handle to the result of an asynchronous wait delegate invoked
+/// using AsyncInvokeFuture(). Copies share the same result. A result is empty if the
+/// target thread rejected or discarded the message, e.g. a full bounded queue or a
+/// thread that exited first.
+template <class RetType>
+class DelegateFuture
+{
+public:
+    using ValueType = typename DelegateFutureState<RetType>::ValueType;
+
+    DelegateFuture() = default;
+    explicit DelegateFuture(std::shared_ptr<DelegateFutureState<RetType>> state) :
+        m_state(std::move(state))
+    {
+    }
+
+    /// @return True if the future refers to an invocation.
+    bool IsValid() const { return m_state != nullptr; }
+
+    /// Poll for completion without blocking.
+    /// @return True once the target function has run or the invocation failed.
+    bool IsReady() const { ASSERT_TRUE(m_state); return m_state->IsReady(); }
+
+    /// Wait for completion or a timeout.
+    /// @param[in] timeout - maximum time to wait.
+    /// @return True if complete, false if the timeout expired.
+    bool WaitFor(std::chrono::milliseconds timeout) const { return WaitUntil(DelegateDeadline(timeout)); }
+
+    /// Wait for completion or a deadline.
+    /// @param[in] deadline - time to stop waiting.
+    /// @return True if complete, false if the deadline passed.
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline) const { ASSERT_TRUE(m_state); return m_state->WaitUntil(deadline); }
+
+    /// Wait for completion.
+    void Wait() const { WaitUntil(std::chrono::steady_clock::time_point::max()); }
+
+    /// Wait for completion and get the result.
+    /// @return The target function return value (true for a void function), or an
+    ///     empty optional if the invocation failed.
+    std::optional<ValueType> Get() const
+    {
+        Wait();
+        return m_state->GetResult();
+    }
+
+    /// Attach a continuation called with the result, as Get() returns it. The continuation
+    /// runs on the target thread when the function completes, or immediately on the
+    /// calling thread if already complete. To run it on another thread, pass an
+    /// asynchronous delegate.
+    /// @param[in] func - callable taking a std::optional<ValueType>.
+    template <class F>
+    void Then(F&& func) const
+    {
+        ASSERT_TRUE(m_state);
+        m_state->Then(std::forward<F>(func));
+    }
+
+private:
+    std::shared_ptr<DelegateFutureState<RetType>> m_state;
+};
+
+/// Wait with a single timeout for every invocation to complete. Dispatch all the 
+/// invocations with AsyncInvokeFuture() first, so the wait takes the longest latency 
+/// rather than the sum.
+/// @param[in] futures - the invocations to wait for.
+/// @param[in] timeout - maximum time to wait for all of them.
+/// @return The result of each future, in order. Empty for an invocation that failed or
+///     did not complete before the timeout.
+template <class RetType>
+std::vector<std::optional<typename DelegateFuture<RetType>::ValueType>> WhenAll(
+    const std::vector<DelegateFuture<RetType>>& futures, std::chrono::milliseconds timeout)
+{
+    const auto deadline = DelegateDeadline(timeout);
+    std::vector<std::optional<typename DelegateFuture<RetType>::ValueType>> results;
+    results.reserve(futures.size());
+    for (const auto& future : futures)
+    {
+        if (future.WaitUntil(deadline))
+            results.push_back(future.Get());
+        else
+            results.emplace_back();
+    }
+    return results;
+}
+
+/// Wait with a single timeout for the first invocation to complete with a value.
+/// @param[in] futures - the invocations to wait for.
+/// @param[in] timeout - maximum time to wait.
+/// @return The result of each future, in order. The first to complete is set, along with
+///     any others complete by then. All empty if the timeout expired or every invocation
+///     failed.
+template <class RetType>
+std::vector<std::optional<typename DelegateFuture<RetType>::ValueType>> WhenAny(
+    const std::vector<DelegateFuture<RetType>>& futures, std::chrono::milliseconds timeout)
+{
+    // Shared with the continuations, which may run after a timeout returns
+    struct Waiter
+    {
+        std::mutex lock;
+        std::condition_variable cv;
+        size_t pending = 0;
+        bool any = false;
+    };
+    auto waiter = std::make_shared<Waiter>();
+    waiter->pending = futures.size();
+
+    for (const auto& future : futures)
+    {
+        future.Then([waiter](const std::optional<typename DelegateFuture<RetType>::ValueType>& result) {
+            {
+                const std::lock_guard<std::mutex> lock(waiter->lock);
+                waiter->pending--;
+                waiter->any = waiter->any || result.has_value();
+            }
+            waiter->cv.notify_all();
+        });
+    }
+
+    {
+        const auto deadline = DelegateDeadline(timeout);
+        std::unique_lock<std::mutex> lk(waiter->lock);
+        auto done = [&waiter] { return waiter->any || waiter->pending == 0; };
+        if (deadline == std::chrono::steady_clock::time_point::max())
+            waiter->cv.wait(lk, done);
+        else
+            waiter->cv.wait_until(lk, deadline, done);
+    }
+
+    std::vector<std::optional<typename DelegateFuture<RetType>::ValueType>> results;
+    results.reserve(futures.size());
+    for (const auto& future : futures)
+    {
+        if (future.IsReady())
+            results.push_back(future.Get());
+        else
+            results.emplace_back();
+    }
+    return results;
+}
+
+}
+
+#endif
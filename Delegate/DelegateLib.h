@@ -5,9 +5,11 @@
 
 #include "DelegateOpt.h"
 #include "MulticastDelegateSafe.h"
+#include "MulticastDelegateRcu.h"
 #include "SinglecastDelegate.h"
 #include "DelegateAsync.h"
 #include "DelegateAsyncWait.h"
 #include "DelegateSpAsync.h"
+#include "DelegateValue.h"
 
 #endif
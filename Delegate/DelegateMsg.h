@@ -4,7 +4,11 @@
 #include "Fault.h"
 #include "DelegateInvoker.h"
 #include "DelegateParam.h"
+#include "DelegatePriority.h"
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #ifdef USE_XALLOCATOR
 	#include "xallocator.h"
 #endif
@@ -30,333 +34,193 @@ public:
 
     virtual ~DelegateMsgBase() {}
 
+	/// Typed function that invokes a message on its invoker. Set by the sending delegate,
+	/// which knows the concrete invoker and message types.
+	typedef void (*InvokeFunc)(IDelegateInvoker* invoker, DelegateMsgBase& msg);
+
 	/// Get the delegate invoker instance the delegate is registered with.
 	/// @return The invoker instance. 
     std::shared_ptr<IDelegateInvoker> GetDelegateInvoker() const { return m_invoker; }
-	
-private:
-    /// The IDelegateInvoker instance 
-    std::shared_ptr<IDelegateInvoker> m_invoker;
-};
 
-/// @brief A class containing the delegate information passed through 
-/// the message queue. 
-template <typename Param1>
-class DelegateMsg1 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsg1(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1) :
-		DelegateMsgBase(invoker),
-		m_param1(param1)
-	{
-	}
+	/// Set the dispatch priority. Defaults to the priority of the enclosing 
+	/// DelegatePriorityScope, or NORMAL.
+	/// @param[in] priority - the message priority.
+	void SetPriority(DelegatePriority priority) { m_priority = priority; }
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1;	}
+	/// @return The dispatch priority.
+	DelegatePriority GetPriority() const { return m_priority; }
 
-private:
-	/// The data argument passed into the callback function
-	Param1 m_param1;
-};
+	/// Set the coalesce key. When a bounded queue using the COALESCE policy is full, 
+	/// a new message replaces a queued message with the same key. Messages sharing
+	/// a key must be interchangeable. Default is nullptr, never coalesced.
+	/// @param[in] key - any address identifying the message stream.
+	void SetCoalesceKey(const void* key) { m_coalesceKey = key; }
 
-template <typename Param1, typename Param2>
-class DelegateMsg2 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsg2(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2) :
-		DelegateMsgBase(invoker),
-		m_param1(param1),
-		m_param2(param2)
-	{
-	}
+	/// @return The coalesce key, or nullptr if none.
+	const void* GetCoalesceKey() const { return m_coalesceKey; }
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1;	}
-	Param2 GetParam2() const { return m_param2;	}
+	/// Set whether a full bounded queue may discard this message once queued, to make
+	/// room for a newer message. Cleared by senders that wait for the message to be
+	/// invoked. Default is true.
+	/// @param[in] discardable - false to keep the message once queued.
+	void SetDiscardable(bool discardable) { m_discardable = discardable; }
 
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-};
+	/// @return True if a queue may discard this message once queued.
+	bool IsDiscardable() const { return m_discardable; }
 
-template <typename Param1, typename Param2, typename Param3>
-class DelegateMsg3 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsg3(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3) :
-		DelegateMsgBase(invoker),
-		m_param1(param1),
-		m_param2(param2),
-		m_param3(param3)
+	/// Set the typed trampoline used by Invoke().
+	/// @param[in] func - the trampoline function.
+	void SetInvokeFunc(InvokeFunc func) { m_invokeFunc = func; }
+
+	/// Called by the destination thread to invoke the message. Calls the typed trampoline
+	/// if set, avoiding RTTI and shared_ptr copies, otherwise IDelegateInvoker::DelegateInvoke().
+	/// @param[in] msg - the message to invoke.
+	static void Invoke(const std::shared_ptr<DelegateMsgBase>& msg)
 	{
+		if (msg->m_invokeFunc)
+			msg->m_invokeFunc(msg->m_invoker.get(), *msg);
+		else
+			msg->m_invoker->DelegateInvoke(msg);
 	}
-
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1;	}
-	Param2 GetParam2() const { return m_param2;	}
-	Param3 GetParam3() const { return m_param3;	}
-
+	
 private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-};
+    /// The IDelegateInvoker instance 
+    std::shared_ptr<IDelegateInvoker> m_invoker;
 
-template <typename Param1, typename Param2, typename Param3, typename Param4>
-class DelegateMsg4 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsg4(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3, Param4 param4) :
-		DelegateMsgBase(invoker),
-		m_param1(param1),
-		m_param2(param2),
-		m_param3(param3),
-		m_param4(param4)
-	{
-	}
+    /// Optional typed trampoline 
+    InvokeFunc m_invokeFunc = nullptr;
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1;	}
-	Param2 GetParam2() const { return m_param2;	}
-	Param3 GetParam3() const { return m_param3;	}
-	Param4 GetParam4() const { return m_param4;	}
+	/// Dispatch priority
+	DelegatePriority m_priority = DelegatePriorityScope::Resolve(DelegatePriority::NORMAL);
 
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-	Param4 m_param4;
+	/// Bounded queue overflow handling
+	bool m_discardable = true;
+	const void* m_coalesceKey = nullptr;
 };
 
-template <typename Param1, typename Param2, typename Param3, typename Param4, typename Param5>
-class DelegateMsg5 : public DelegateMsgBase
+/// @brief A message containing the delegate function arguments passed through the 
+/// message queue. Arguments are stored as the function declares them, so reference and 
+/// pointer arguments refer to the caller's objects. Rvalue reference arguments are moved
+/// into the message. Used by the blocking delegates where the caller waits for the 
+/// target function to complete.
+template <typename... Args>
+class DelegateMsg : public DelegateMsgBase
 {
 public:
 	/// Constructor
 	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsg5(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3, Param4 param4, Param5 param5) :
+	/// @param[in] args - the function arguments. Forwarded into the message.
+	template <typename... Ts>
+	DelegateMsg(std::shared_ptr<IDelegateInvoker> invoker, Ts&&... args) :
 		DelegateMsgBase(invoker),
-		m_param1(param1),
-		m_param2(param2),
-		m_param3(param3),
-		m_param4(param4),
-		m_param5(param5)
+		m_args(std::forward<Ts>(args)...)
 	{
 	}
 
 	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1;	}
-	Param2 GetParam2() const { return m_param2;	}
-	Param3 GetParam3() const { return m_param3;	}
-	Param4 GetParam4() const { return m_param4;	}
-	Param5 GetParam5() const { return m_param5;	}
-
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-	Param4 m_param4;
-	Param5 m_param5;
-};
+	/// @return The function arguments. 
+	std::tuple<ArgStorageOf<Args>...>& GetArgs() { return m_args; }
 
-/// @brief A class containing the delegate information passed through 
-/// the message queue. 
-template <typename Param1>
-class DelegateMsgHeapParam1 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsgHeapParam1(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1) :
-		DelegateMsgBase(invoker),
-		m_param1(DelegateParam<Param1>::New(param1))
+	/// Call func with the stored arguments. The destination thread invokes a message 
+	/// once, so pass by value arguments are moved out of the message.
+	/// @param[in] func - the callable to invoke.
+	template <typename F>
+	void Apply(F&& func)
 	{
+		std::apply([&func](auto&... args) { func(TakeArg<Args>(args)...); }, m_args);
 	}
 
-	~DelegateMsgHeapParam1()
+private:
+	template <typename Arg, typename T>
+	static decltype(auto) TakeArg(T& arg)
 	{
-		DelegateParam<Param1>::Delete(m_param1);
+		if constexpr (std::is_lvalue_reference<Arg>::value)
+			return static_cast<T&>(arg);
+		else
+			return std::move(arg);
 	}
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1; }
-
-private:
-	/// The data argument passed into the callback function
-	Param1 m_param1;
+	/// The data arguments passed into the invoked function
+	std::tuple<ArgStorageOf<Args>...> m_args;
 };
 
-template <typename Param1, typename Param2>
-class DelegateMsgHeapParam2 : public DelegateMsgBase
+/// @brief A message that owns a copy of every delegate function argument, so the caller 
+/// does not need to wait for the target function. Pointer and reference arguments are 
+/// copied using DelegateParam<>::New() and released using DelegateParam<>::Delete() 
+/// when the message is destroyed. Pass by value and rvalue reference arguments are moved 
+/// into the message, so move-only types such as std::unique_ptr<> are supported. 
+template <typename... Args>
+class DelegateMsgHeapArgs : public DelegateMsgBase
 {
 public:
 	/// Constructor
 	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsgHeapParam2(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2) :
+	/// @param[in] args - the function arguments. Forwarded into the message.
+	template <typename... Ts>
+	DelegateMsgHeapArgs(std::shared_ptr<IDelegateInvoker> invoker, Ts&&... args) :
 		DelegateMsgBase(invoker),
-		m_param1(DelegateParam<Param1>::New(param1)),
-		m_param2(DelegateParam<Param2>::New(param2))
+		m_args(NewArg<Args>(std::forward<Ts>(args))...)
 	{
 	}
 
-	~DelegateMsgHeapParam2()
+	~DelegateMsgHeapArgs()
 	{
-		DelegateParam<Param1>::Delete(m_param1);
-		DelegateParam<Param2>::Delete(m_param2);
+		std::apply([](auto&... args) { (DeleteArg<Args>(args), ...); }, m_args);
 	}
 
 	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1; }
-	Param2 GetParam2() const { return m_param2; }
-
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-};
-
-template <typename Param1, typename Param2, typename Param3>
-class DelegateMsgHeapParam3 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsgHeapParam3(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3) :
-		DelegateMsgBase(invoker),
-		m_param1(DelegateParam<Param1>::New(param1)),
-		m_param2(DelegateParam<Param2>::New(param2)),
-		m_param3(DelegateParam<Param3>::New(param3))
-	{
-	}
+	/// @return The function arguments. 
+	std::tuple<ArgStorageOf<Args>...>& GetArgs() { return m_args; }
 
-	~DelegateMsgHeapParam3()
+	/// Call func with the stored arguments. The destination thread invokes a message 
+	/// once, so pass by value arguments are moved out of the message.
+	/// @param[in] func - the callable to invoke.
+	template <typename F>
+	void Apply(F&& func)
 	{
-		DelegateParam<Param1>::Delete(m_param1);
-		DelegateParam<Param2>::Delete(m_param2);
-		DelegateParam<Param3>::Delete(m_param3);
+		std::apply([&func](auto&... args) { func(TakeArg<Args>(args)...); }, m_args);
 	}
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1; }
-	Param2 GetParam2() const { return m_param2; }
-	Param3 GetParam3() const { return m_param3; }
-
 private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-};
+	DelegateMsgHeapArgs(const DelegateMsgHeapArgs&) = delete;
+	DelegateMsgHeapArgs& operator=(const DelegateMsgHeapArgs&) = delete;
 
-template <typename Param1, typename Param2, typename Param3, typename Param4>
-class DelegateMsgHeapParam4 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsgHeapParam4(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3, Param4 param4) :
-		DelegateMsgBase(invoker),
-		m_param1(DelegateParam<Param1>::New(param1)),
-		m_param2(DelegateParam<Param2>::New(param2)),
-		m_param3(DelegateParam<Param3>::New(param3)),
-		m_param4(DelegateParam<Param4>::New(param4))
+	/// True if Arg is moved into the message: an rvalue reference, or passed by value
+	/// using the library default DelegateParam<> which requires no New()/Delete() call. 
+	template <typename Arg>
+	static constexpr bool IsPlainValue()
 	{
+		return std::is_rvalue_reference<Arg>::value || 
+			(!std::is_reference<Arg>::value && !std::is_pointer<Arg>::value && is_default_param<Arg>::value);
 	}
 
-	~DelegateMsgHeapParam4()
+	template <typename Arg, typename T>
+	static decltype(auto) NewArg(T&& arg)
 	{
-		DelegateParam<Param1>::Delete(m_param1);
-		DelegateParam<Param2>::Delete(m_param2);
-		DelegateParam<Param3>::Delete(m_param3);
-		DelegateParam<Param4>::Delete(m_param4);
+		if constexpr (IsPlainValue<Arg>())
+			return std::forward<T>(arg);
+		else
+			return DelegateParam<Arg>::New(arg);
 	}
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1; }
-	Param2 GetParam2() const { return m_param2; }
-	Param3 GetParam3() const { return m_param3; }
-	Param4 GetParam4() const { return m_param4; }
-
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-	Param4 m_param4;
-};
-
-template <typename Param1, typename Param2, typename Param3, typename Param4, typename Param5>
-class DelegateMsgHeapParam5 : public DelegateMsgBase
-{
-public:
-	/// Constructor
-	/// @param[in] invoker - the invoker instance the delegate is registered with.
-	/// @param[in] param1 - the data sent as delegate function argument.
-	DelegateMsgHeapParam5(std::shared_ptr<IDelegateInvoker> invoker, Param1 param1, Param2 param2, Param3 param3, Param4 param4, Param5 param5) :
-		DelegateMsgBase(invoker),
-		m_param1(DelegateParam<Param1>::New(param1)),
-		m_param2(DelegateParam<Param2>::New(param2)),
-		m_param3(DelegateParam<Param3>::New(param3)),
-		m_param4(DelegateParam<Param4>::New(param4)),
-		m_param5(DelegateParam<Param5>::New(param5))
-
+	template <typename Arg, typename T>
+	static void DeleteArg(T& arg)
 	{
+		if constexpr (!IsPlainValue<Arg>())
+			DelegateParam<Arg>::Delete(arg);
 	}
 
-	~DelegateMsgHeapParam5()
+	template <typename Arg, typename T>
+	static decltype(auto) TakeArg(T& arg)
 	{
-		DelegateParam<Param1>::Delete(m_param1);
-		DelegateParam<Param2>::Delete(m_param2);
-		DelegateParam<Param3>::Delete(m_param3);
-		DelegateParam<Param4>::Delete(m_param4);
-		DelegateParam<Param5>::Delete(m_param5);
+		if constexpr (IsPlainValue<Arg>())
+			return std::move(arg);
+		else
+			return static_cast<T&>(arg);
 	}
 
-	/// Get the delegate data passed into the delegate function. 
-	/// @return The param1 delegate function data. 
-	Param1 GetParam1() const { return m_param1; }
-	Param2 GetParam2() const { return m_param2; }
-	Param3 GetParam3() const { return m_param3; }
-	Param4 GetParam4() const { return m_param4; }
-	Param5 GetParam5() const { return m_param5; }
-
-private:
-	/// The data argument passed into the invoked function
-	Param1 m_param1;
-	Param2 m_param2;
-	Param3 m_param3;
-	Param4 m_param4;
-	Param5 m_param5;
+	/// The data arguments passed into the invoked function
+	std::tuple<ArgStorageOf<Args>...> m_args;
 };
 
 }
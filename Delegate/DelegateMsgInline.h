@@ -0,0 +1,258 @@
+#ifndef _DELEGATE_MSG_INLINE_H
+#define _DELEGATE_MSG_INLINE_H
+
+// DelegateMsgInline.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Type-erased delegate message with fixed-size inline storage. An asynchronous delegate
+// using inline dispatch constructs a copy of its bound target and the function arguments
+// directly within the message. The message is then moved into a slot within the target
+// thread's queue, so a typical invocation requires no heap allocation at all.
+
+#include "DelegateOpt.h"
+#include "DelegateParam.h"
+#include "DelegatePriority.h"
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace DelegateLib {
+
+/// @brief A move-only, type-erased callable with DELEGATE_MSG_INLINE_SIZE bytes of inline
+/// storage. Callables too large for the storage, or that may throw when moved, are
+/// allocated on the heap instead.
+class DelegateMsgInline
+{
+public:
+	DelegateMsgInline() = default;
+
+	/// Constructor
+	/// @param[in] func - a callable taking no arguments. Moved into the message.
+	template <class F, class = std::enable_if_t<!std::is_same<std::decay_t<F>, DelegateMsgInline>::value>>
+	explicit DelegateMsgInline(F&& func)
+	{
+		using Func = std::decay_t<F>;
+		if constexpr (FitsInline<Func>())
+		{
+			new (m_storage) Func(std::forward<F>(func));
+			m_ops = &InlineOps<Func>::OPS;
+		}
+		else
+		{
+			*reinterpret_cast<Func**>(m_storage) = new Func(std::forward<F>(func));
+			m_ops = &HeapOps<Func>::OPS;
+		}
+	}
+
+	DelegateMsgInline(DelegateMsgInline&& rhs) noexcept { MoveFrom(rhs); }
+
+	DelegateMsgInline& operator=(DelegateMsgInline&& rhs) noexcept
+	{
+		if (&rhs != this)
+		{
+			Reset();
+			MoveFrom(rhs);
+		}
+		return *this;
+	}
+
+	~DelegateMsgInline() { Reset(); }
+
+	/// Invoke the stored callable. Called once by the destination thread.
+	void Invoke() { m_ops->invoke(m_storage); }
+
+	/// Destroy the stored callable, if any.
+	void Reset()
+	{
+		if (m_ops)
+		{
+			m_ops->destroy(m_storage);
+			m_ops = nullptr;
+		}
+	}
+
+	/// Set the dispatch priority. Defaults to the priority of the enclosing 
+	/// DelegatePriorityScope, or NORMAL.
+	/// @param[in] priority - the message priority.
+	void SetPriority(DelegatePriority priority) { m_priority = priority; }
+
+	/// @return The dispatch priority.
+	DelegatePriority GetPriority() const { return m_priority; }
+
+	/// Set the coalesce key. @see DelegateMsgBase::SetCoalesceKey()
+	/// @param[in] key - any address identifying the message stream.
+	void SetCoalesceKey(const void* key) { m_coalesceKey = key; }
+
+	/// @return The coalesce key, or nullptr if none.
+	const void* GetCoalesceKey() const { return m_coalesceKey; }
+
+	/// Set whether a queue may discard the message. @see DelegateMsgBase::SetDiscardable()
+	/// @param[in] discardable - false to keep the message once queued.
+	void SetDiscardable(bool discardable) { m_discardable = discardable; }
+
+	/// @return True if a queue may discard this message once queued.
+	bool IsDiscardable() const { return m_discardable; }
+
+	/// @return True if no callable is stored.
+	bool Empty() const { return m_ops == nullptr; }
+
+	/// @return True if the callable is held within the inline storage, false if
+	/// it was too large and is held on the heap.
+	bool IsInline() const { return m_ops && m_ops->isInline; }
+
+	explicit operator bool() const { return !Empty(); }
+
+	/// @return True if a callable of type F is stored without a heap allocation.
+	template <class F>
+	static constexpr bool FitsInline()
+	{
+		return sizeof(F) <= sizeof(m_storage) &&
+			alignof(F) <= alignof(std::max_align_t) &&
+			std::is_nothrow_move_constructible<F>::value;
+	}
+
+private:
+	DelegateMsgInline(const DelegateMsgInline&) = delete;
+	DelegateMsgInline& operator=(const DelegateMsgInline&) = delete;
+
+	/// Operations on the stored callable
+	struct Ops
+	{
+		void (*invoke)(void* storage);
+		void (*destroy)(void* storage);
+		void (*move)(void* dst, void* src);
+		bool isInline;
+	};
+
+	template <class F>
+	struct InlineOps
+	{
+		static void Invoke(void* storage) { (*static_cast<F*>(storage))(); }
+		static void Destroy(void* storage) { static_cast<F*>(storage)->~F(); }
+		static void Move(void* dst, void* src)
+		{
+			new (dst) F(std::move(*static_cast<F*>(src)));
+			static_cast<F*>(src)->~F();
+		}
+		static constexpr Ops OPS = { &Invoke, &Destroy, &Move, true };
+	};
+
+	template <class F>
+	struct HeapOps
+	{
+		static void Invoke(void* storage) { (**static_cast<F**>(storage))(); }
+		static void Destroy(void* storage) { delete *static_cast<F**>(storage); }
+		static void Move(void* dst, void* src) { *static_cast<F**>(dst) = *static_cast<F**>(src); }
+		static constexpr Ops OPS = { &Invoke, &Destroy, &Move, false };
+	};
+
+	void MoveFrom(DelegateMsgInline& rhs) noexcept
+	{
+		m_priority = rhs.m_priority;
+		m_discardable = rhs.m_discardable;
+		m_coalesceKey = rhs.m_coalesceKey;
+		if (rhs.m_ops)
+		{
+			rhs.m_ops->move(m_storage, rhs.m_storage);
+			m_ops = rhs.m_ops;
+			rhs.m_ops = nullptr;
+		}
+	}
+
+	alignas(std::max_align_t) unsigned char m_storage[DELEGATE_MSG_INLINE_SIZE];
+	const Ops* m_ops = nullptr;
+	DelegatePriority m_priority = DelegatePriorityScope::Resolve(DelegatePriority::NORMAL);
+	bool m_discardable = true;
+	const void* m_coalesceKey = nullptr;
+};
+
+/// @brief Storage for one function argument within an inline message. Pass by value
+/// arguments are moved into the message and moved out again when invoked. Pointer and reference arguments using the default DelegateParam<>
+/// keep a copy of the pointee inside the message itself. All other arguments (e.g. pointer
+/// to pointer, or a user DelegateParam<> specialization) use DelegateParam<> New/Delete.
+template <typename Param, typename Enable = void>
+class DelegateArg
+{
+public:
+	explicit DelegateArg(Param param) : m_param(std::move(param)) {}
+	Param&& Get() { return std::move(m_param); }
+private:
+	Param m_param;
+};
+
+template <typename Param>
+class DelegateArg<Param*, std::enable_if_t<is_default_param<Param*>::value && !std::is_pointer<Param>::value>>
+{
+public:
+	explicit DelegateArg(Param* param) : m_param(*param) {}
+	Param* Get() { return &m_param; }
+private:
+	std::remove_const_t<Param> m_param;
+};
+
+template <typename Param>
+class DelegateArg<Param*, std::enable_if_t<!(is_default_param<Param*>::value && !std::is_pointer<Param>::value)>>
+{
+public:
+	explicit DelegateArg(Param* param) : m_param(DelegateParam<Param*>::New(param)) {}
+	DelegateArg(DelegateArg&& rhs) noexcept : m_param(rhs.m_param) { rhs.m_param = nullptr; }
+	~DelegateArg() { if (m_param) DelegateParam<Param*>::Delete(m_param); }
+	Param* Get() { return m_param; }
+private:
+	DelegateArg(const DelegateArg&) = delete;
+	DelegateArg& operator=(const DelegateArg&) = delete;
+	Param* m_param;
+};
+
+template <typename Param>
+class DelegateArg<Param&, std::enable_if_t<is_default_param<Param&>::value>>
+{
+public:
+	explicit DelegateArg(Param& param) : m_param(param) {}
+	Param& Get() { return m_param; }
+private:
+	std::remove_const_t<Param> m_param;
+};
+
+template <typename Param>
+class DelegateArg<Param&, std::enable_if_t<!is_default_param<Param&>::value>>
+{
+public:
+	explicit DelegateArg(Param& param) : m_param(&DelegateParam<Param&>::New(param)) {}
+	DelegateArg(DelegateArg&& rhs) noexcept : m_param(rhs.m_param) { rhs.m_param = nullptr; }
+	~DelegateArg() { if (m_param) DelegateParam<Param&>::Delete(*m_param); }
+	Param& Get() { return *m_param; }
+private:
+	DelegateArg(const DelegateArg&) = delete;
+	DelegateArg& operator=(const DelegateArg&) = delete;
+	Param* m_param;
+};
+
+/// @brief The callable an asynchronous delegate places within a DelegateMsgInline.
+/// Holds a copy of the synchronous target delegate and the function arguments.
+/// @tparam TDelegate - the synchronous delegate type (e.g. DelegateFree<>).
+template <class TDelegate, class... Args>
+class DelegateInlineCall
+{
+public:
+	DelegateInlineCall(const TDelegate& delegate, Args... args) :
+		m_delegate(delegate), m_args(DelegateArg<ArgStorageOf<Args>>(std::forward<Args>(args))...)
+	{
+	}
+
+	/// Invoke the target function on the destination thread
+	void operator()()
+	{
+		std::apply([this](auto&... args) { m_delegate(args.Get()...); }, m_args);
+	}
+
+private:
+	TDelegate m_delegate;
+	std::tuple<DelegateArg<ArgStorageOf<Args>>...> m_args;
+};
+
+}
+
+#endif
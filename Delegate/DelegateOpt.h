@@ -35,4 +35,24 @@
 // @see https://github.com/endurodave/xallocator
 //#define USE_XALLOCATOR
 
+// Size in bytes of the inline storage within a DelegateMsgInline. An asynchronous delegate
+// using inline dispatch places a copy of its bound target and the function arguments into 
+// this storage. Payloads that do not fit fall back to a heap allocation. 
+#ifndef DELEGATE_MSG_INLINE_SIZE
+	#define DELEGATE_MSG_INLINE_SIZE 96
+#endif
+
+// Size in bytes of the storage for one delegate within a MulticastDelegate invocation list.
+// Delegates that fit are stored inline within the list; larger delegates are heap allocated.
+// The default holds every non-blocking delegate type.
+#ifndef DELEGATE_SLOT_SIZE
+	#define DELEGATE_SLOT_SIZE 80
+#endif
+
+// Number of reader counters per epoch within a MulticastDelegateRcu. Threads invoking 
+// the same container are spread over the counters to avoid contending for one cache line.
+#ifndef DELEGATE_RCU_SHARDS
+	#define DELEGATE_RCU_SHARDS 8
+#endif
+
 #endif
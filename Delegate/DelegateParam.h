@@ -1,6 +1,7 @@
 #ifndef _DELEGATE_PARAM_H
 #define _DELEGATE_PARAM_H
 
+#include <type_traits>
 
 namespace DelegateLib
 {
@@ -11,6 +12,9 @@ template <typename Param>
 class DelegateParam
 {
 public:
+	/// The library default performs no copy. Messages move the value directly. 
+	static const bool IS_DEFAULT = true;
+
 	static Param New(Param param) {	return param; }
 	static void Delete(Param param) { }
 };
@@ -21,6 +25,10 @@ template <typename Param>
 class DelegateParam<Param *>
 {
 public:
+	/// The library default copies the pointee. DelegateArg uses this to store the 
+	/// copy inside an inline message instead of on the heap. 
+	static const bool IS_DEFAULT = true;
+
 	static Param* New(Param* param)	{
 #ifdef USE_XALLOCATOR
 		void* mem = xmalloc(sizeof(*param));
@@ -78,6 +86,10 @@ template <typename Param>
 class DelegateParam<Param &>
 {
 public:
+	/// The library default copies the referenced object. DelegateArg uses this to 
+	/// store the copy inside an inline message instead of on the heap. 
+	static const bool IS_DEFAULT = true;
+
 	static Param& New(Param& param)	{
 #ifdef USE_XALLOCATOR
 		void* mem = xmalloc(sizeof(param));
@@ -98,6 +110,19 @@ public:
 	}
 };
 
+// Detects the library's default DelegateParam<> implementations. A user specialization
+// (e.g. one that passes a pointer through without copying) must be honored as is.
+template <typename Param, typename = void>
+struct is_default_param : std::false_type {};
+
+template <typename Param>
+struct is_default_param<Param, std::void_t<decltype(DelegateParam<Param>::IS_DEFAULT)>> : std::true_type {};
+
+// Get the type used to hold a function argument within a message. An rvalue reference 
+// argument is held by value so the message owns the object moved into it.
+template <typename Param>
+using ArgStorageOf = std::conditional_t<std::is_rvalue_reference<Param>::value, std::remove_reference_t<Param>, Param>;
+
 }
 
 #endif
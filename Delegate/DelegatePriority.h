@@ -0,0 +1,60 @@
+#ifndef _DELEGATE_PRIORITY_H
+#define _DELEGATE_PRIORITY_H
+
+// DelegatePriority.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Dispatch priority of asynchronous delegate messages. A DelegateThread that supports
+// priorities (e.g. WorkerThread) invokes higher priority messages first; other
+// implementations ignore the priority.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DelegateLib {
+
+/// Priority of a delegate message within its target thread's queue
+enum class DelegatePriority : uint8_t
+{
+    LOW,
+    NORMAL,
+    HIGH
+};
+
+/// Number of DelegatePriority levels
+const size_t DELEGATE_PRIORITIES = 3;
+
+/// @brief Sets the priority of every message the calling thread dispatches for the
+/// lifetime of the scope, overriding the priority set on each delegate. Used to give
+/// a single call a priority, e.g. when invoking a multicast delegate.
+class DelegatePriorityScope
+{
+public:
+    explicit DelegatePriorityScope(DelegatePriority priority) : m_prev(Override()) {
+        Override() = static_cast<int>(priority);
+    }
+    ~DelegatePriorityScope() { Override() = m_prev; }
+
+    /// @param[in] priority - the priority set on the dispatching delegate.
+    /// @return The priority of a message dispatched by the calling thread.
+    static DelegatePriority Resolve(DelegatePriority priority) {
+        const int priorityOverride = Override();
+        return priorityOverride < 0 ? priority : static_cast<DelegatePriority>(priorityOverride);
+    }
+
+private:
+    DelegatePriorityScope(const DelegatePriorityScope&) = delete;
+    DelegatePriorityScope& operator=(const DelegatePriorityScope&) = delete;
+
+    /// @return The calling thread's priority override, or -1 if none.
+    static int& Override() {
+        thread_local int priorityOverride = -1;
+        return priorityOverride;
+    }
+
+    const int m_prev;
+};
+
+}
+
+#endif
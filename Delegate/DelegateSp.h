@@ -44,11 +44,12 @@ public:
     }
 
     virtual DelegateMemberSp* Clone() const override { return new DelegateMemberSp(*this); }
+    virtual DelegateMemberSp* CloneTo(void* buffer, size_t size) const override { return DelegateCloneTo(*this, buffer, size); }
 
     // Invoke the bound delegate function
     virtual RetType operator()(Args... args) override {
         //if (m_object)
-            return (*m_object.*m_func)(args...);
+            return (*m_object.*m_func)(std::forward<Args>(args)...);
         //else
         //    return RetType();
     }
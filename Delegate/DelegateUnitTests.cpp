@@ -1,9 +1,19 @@
 #ifdef DELEGATE_UNIT_TESTS
 
 #include "DelegateLib.h"
+#include "Timer.h"
+#include "DelegateAsyncRequest.h"
+#include "DelegateCoroutine.h"
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <string>
+#include <atomic>
 #if USE_STD_THREADS
 	#include "WorkerThreadStd.h"
+	#include "WorkerThreadMpsc.h"
+	#include "WorkerThreadPool.h"
+	#include "WorkerStrand.h"
 #elif USE_WIN32_THREADS
 	#include "WorkerThreadWin.h"
 #endif
@@ -11,6 +21,9 @@
 using namespace DelegateLib;
 
 WorkerThread testThread("DelegateUnitTestsThread");
+#if USE_STD_THREADS
+WorkerThreadMpsc testThreadMpsc("DelegateUnitTestsMpscThread");
+#endif
 
 static const INT TEST_INT = 12345678;
 
@@ -1874,6 +1887,15 @@ void DelegateMemberAsyncSpTests()
 	std::shared_ptr<TestClass5> testClass5(new TestClass5());
 	auto DelegateMemberAsyncSp5 = MakeDelegate(testClass5, &TestClass5::MemberFuncInt5, testThread);
 	DelegateMemberAsyncSp5(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT);
+
+	// The dispatch options shared with DelegateMemberAsync
+	DelegateMemberAsyncSp1.SetInlineDispatch(true);
+	ASSERT_TRUE(DelegateMemberAsyncSp1.GetInlineDispatch());
+	ASSERT_TRUE(DelegateMemberAsyncSp1.AsyncInvoke(TEST_INT));
+	DelegateMemberAsyncSp1.SetConflate(true);
+	ASSERT_TRUE(DelegateMemberAsyncSp1.GetConflate() && !DelegateMemberAsyncSp1.GetSyncDelegate());
+	ASSERT_TRUE(DelegateMemberAsyncSp1.AsyncInvoke(TEST_INT));
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
 }
 
 void DelegateMemberAsyncWaitTests()
@@ -2544,9 +2566,2022 @@ void DelegateMemberAsyncWaitTests()
 		int ret = MemberFuncIntWithReturn5Delegate(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT);
 }
 
+static std::atomic<INT> inlineCount(0);
+
+void FreeFuncInlineCount(INT i) { ASSERT_TRUE(i == TEST_INT); inlineCount++; }
+
+void InlineDispatchTests()
+{
+	StructParam structParam;
+	structParam.val = TEST_INT;
+	StructParam* pStructParam = &structParam;
+	TestClass1 testClass1;
+	TestClass2 testClass2;
+	inlineCount = 0;
+
+	// A small callable is held inline; a large callable falls back to the heap
+	DelegateMsgInline smallMsg([]() { inlineCount++; });
+	ASSERT_TRUE(smallMsg.IsInline());
+	char large[DELEGATE_MSG_INLINE_SIZE + 1] = { 0 };
+	DelegateMsgInline largeMsg([large]() { inlineCount += large[0] + 1; });
+	ASSERT_TRUE(!largeMsg.IsInline());
+	DelegateMsgInline movedMsg(std::move(largeMsg));
+	ASSERT_TRUE(largeMsg.Empty());
+	smallMsg.Invoke();
+	movedMsg.Invoke();
+	ASSERT_TRUE(inlineCount == 2);
+
+	auto FreeFuncInt1Delegate = MakeDelegate(&FreeFuncInt1, testThread);
+	FreeFuncInt1Delegate.SetInlineDispatch(true);
+	ASSERT_TRUE(FreeFuncInt1Delegate.GetInlineDispatch());
+	FreeFuncInt1Delegate(TEST_INT);
+
+	auto FreeFuncStruct1Delegate = MakeDelegate(&FreeFuncStruct1, testThread);
+	FreeFuncStruct1Delegate.SetInlineDispatch(true);
+	FreeFuncStruct1Delegate(structParam);
+
+	// Pointer and reference arguments are copied into the message; changing the
+	// caller's object after dispatch must not affect the target function
+	auto FreeFuncStructPtr1Delegate = MakeDelegate(&FreeFuncStructPtr1, testThread);
+	FreeFuncStructPtr1Delegate.SetInlineDispatch(true);
+	FreeFuncStructPtr1Delegate(&structParam);
+
+	auto FreeFuncStructConstPtr1Delegate = MakeDelegate(&FreeFuncStructConstPtr1, testThread);
+	FreeFuncStructConstPtr1Delegate.SetInlineDispatch(true);
+	FreeFuncStructConstPtr1Delegate(&structParam);
+
+	auto FreeFuncStructRef1Delegate = MakeDelegate(&FreeFuncStructRef1, testThread);
+	FreeFuncStructRef1Delegate.SetInlineDispatch(true);
+	FreeFuncStructRef1Delegate(structParam);
+
+	auto FreeFuncStructConstRef1Delegate = MakeDelegate(&FreeFuncStructConstRef1, testThread);
+	FreeFuncStructConstRef1Delegate.SetInlineDispatch(true);
+	FreeFuncStructConstRef1Delegate(structParam);
+
+	auto FreeFuncPtrPtr1Delegate = MakeDelegate(&FreeFuncPtrPtr1, testThread);
+	FreeFuncPtrPtr1Delegate.SetInlineDispatch(true);
+	FreeFuncPtrPtr1Delegate(&pStructParam);
+
+	auto MemberFuncStructPtr1Delegate = MakeDelegate(&testClass1, &TestClass1::MemberFuncStructPtr1, testThread);
+	MemberFuncStructPtr1Delegate.SetInlineDispatch(true);
+	MemberFuncStructPtr1Delegate(&structParam);
+
+	auto MemberFuncStructConstRef2Delegate = MakeDelegate(&testClass2, &TestClass2::MemberFuncStructConstRef2, testThread);
+	MemberFuncStructConstRef2Delegate.SetInlineDispatch(true);
+	MemberFuncStructConstRef2Delegate(structParam, TEST_INT);
+
+	structParam.val = 0;
+
+	// Inline and heap messages share one queue and run in order
+	auto FreeFuncInlineCountDelegate = MakeDelegate(&FreeFuncInlineCount, testThread);
+	FreeFuncInlineCountDelegate.SetInlineDispatch(true);
+	for (INT i = 0; i < 10; i++)
+		FreeFuncInlineCountDelegate(TEST_INT);
+
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(inlineCount == 12);
+}
+
+static std::atomic<INT> sharedTargetCount(0);
+
+void FreeFuncSharedTarget(INT i) { ASSERT_TRUE(i == TEST_INT); sharedTargetCount++; }
+void FreeFuncSharedTarget2(INT i) { ASSERT_TRUE(i == TEST_INT); sharedTargetCount += 100; }
+
+class TestClassSharedTarget
+{
+public:
+	void MemberFunc(const StructParam& s) { ASSERT_TRUE(s.val == TEST_INT); sharedTargetCount++; }
+};
+
+void SharedTargetTests()
+{
+	StructParam structParam;
+	structParam.val = TEST_INT;
+	TestClassSharedTarget testClass;
+	std::shared_ptr<TestClassSharedTarget> testClassSp(new TestClassSharedTarget());
+	sharedTargetCount = 0;
+
+	auto FreeFuncDelegate = MakeDelegate(&FreeFuncSharedTarget, testThread);
+	ASSERT_TRUE(!FreeFuncDelegate.GetSharedTarget());
+	FreeFuncDelegate.SetSharedTarget(true);
+	ASSERT_TRUE(FreeFuncDelegate.GetSharedTarget());
+	for (INT i = 0; i < 10; i++)
+		FreeFuncDelegate(TEST_INT);
+
+	// Rebinding recreates the shared target
+	FreeFuncDelegate.Bind(&FreeFuncSharedTarget2, testThread);
+	FreeFuncDelegate(TEST_INT);
+
+	auto MemberFuncDelegate = MakeDelegate(&testClass, &TestClassSharedTarget::MemberFunc, testThread);
+	MemberFuncDelegate.SetSharedTarget(true);
+	for (INT i = 0; i < 10; i++)
+		MemberFuncDelegate(structParam);
+
+	auto MemberFuncSpDelegate = MakeDelegate(testClassSp, &TestClassSharedTarget::MemberFunc, testThread);
+	MemberFuncSpDelegate.SetSharedTarget(true);
+	for (INT i = 0; i < 10; i++)
+		MemberFuncSpDelegate(structParam);
+
+	// A container clone shares the same target
+	MulticastDelegateSafe<void(INT)> multicast;
+	multicast += FreeFuncDelegate;
+	multicast(TEST_INT);
+	multicast.Clear();
+
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(sharedTargetCount == 10 + 100 + 10 + 10 + 100);
+
+	FreeFuncDelegate.Clear();
+	ASSERT_TRUE(FreeFuncDelegate.Empty());
+}
+
+static std::atomic<INT> manyArgsCount(0);
+
+void FreeFuncManyArgs(INT i, INT i2, INT i3, INT i4, INT i5, StructParam* s, StructParam& s2, const StructParam& s3)
+{
+	ASSERT_TRUE(i == TEST_INT && i2 == TEST_INT && i3 == TEST_INT && i4 == TEST_INT && i5 == TEST_INT);
+	ASSERT_TRUE(s->val == TEST_INT && s2.val == TEST_INT && s3.val == TEST_INT);
+	manyArgsCount++;
+}
+
+INT FreeFuncManyArgsWithReturn(INT i, INT i2, INT i3, INT i4, INT i5, INT i6, INT i7) 
+{ 
+	return i + i2 + i3 + i4 + i5 + i6 + i7; 
+}
+
+class TestClassManyArgs
+{
+public:
+	void MemberFunc(INT i, INT i2, INT i3, INT i4, INT i5, INT i6) { ASSERT_TRUE(i6 == TEST_INT); manyArgsCount++; }
+};
+
+/// Counts copies made while a value argument travels through a message
+struct CopyCounter
+{
+	CopyCounter() = default;
+	CopyCounter(const CopyCounter& rhs) : val(rhs.val) { copies++; }
+	CopyCounter(CopyCounter&& rhs) noexcept : val(rhs.val) { }
+	CopyCounter& operator=(const CopyCounter& rhs) { val = rhs.val; copies++; return *this; }
+	CopyCounter& operator=(CopyCounter&& rhs) noexcept { val = rhs.val; return *this; }
+	INT val = TEST_INT;
+	static std::atomic<INT> copies;
+};
+std::atomic<INT> CopyCounter::copies(0);
+
+void FreeFuncCopyCounter(CopyCounter c) { ASSERT_TRUE(c.val == TEST_INT); manyArgsCount++; }
+
+void VariadicArgsTests()
+{
+	StructParam structParam;
+	structParam.val = TEST_INT;
+	TestClassManyArgs testClass;
+	std::shared_ptr<TestClassManyArgs> testClassSp(new TestClassManyArgs());
+	manyArgsCount = 0;
+
+	// More than five arguments
+	auto FreeFuncManyArgsDelegate = MakeDelegate(&FreeFuncManyArgs, testThread);
+	FreeFuncManyArgsDelegate(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT, &structParam, structParam, structParam);
+
+	auto MemberFuncDelegate = MakeDelegate(&testClass, &TestClassManyArgs::MemberFunc, testThread);
+	MemberFuncDelegate(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT);
+
+	auto MemberFuncSpDelegate = MakeDelegate(testClassSp, &TestClassManyArgs::MemberFunc, testThread);
+	MemberFuncSpDelegate(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT);
+
+	MulticastDelegateSafe<void(INT, INT, INT, INT, INT, StructParam*, StructParam&, const StructParam&)> multicast;
+	multicast += FreeFuncManyArgsDelegate;
+	multicast += MakeDelegate(&FreeFuncManyArgs);
+	multicast(TEST_INT, TEST_INT, TEST_INT, TEST_INT, TEST_INT, &structParam, structParam, structParam);
+	multicast.Clear();
+
+	auto FreeFuncManyArgsWaitDelegate = MakeDelegate(&FreeFuncManyArgsWithReturn, testThread, WAIT_INFINITE);
+	ASSERT_TRUE(FreeFuncManyArgsWaitDelegate(1, 2, 3, 4, 5, 6, 7) == 28);
+	ASSERT_TRUE(FreeFuncManyArgsWaitDelegate.IsSuccess());
+
+	// A value argument is copied once into the delegate call and moved thereafter
+	// until the target function call itself
+	CopyCounter counter;
+	CopyCounter::copies = 0;
+	auto FreeFuncCopyCounterDelegate = MakeDelegate(&FreeFuncCopyCounter, testThread);
+	FreeFuncCopyCounterDelegate(counter);
+
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(manyArgsCount == 6);
+	ASSERT_TRUE(CopyCounter::copies == 1);
+}
+
+static std::atomic<INT> moveOnlyCount(0);
+static const INT* moveOnlyData = nullptr;
+
+void FreeFuncUniquePtr(std::unique_ptr<StructParam> s) { ASSERT_TRUE(s && s->val == TEST_INT); moveOnlyCount++; }
+void FreeFuncVectorRvalue(std::vector<INT>&& v) { ASSERT_TRUE(v.data() == moveOnlyData); moveOnlyCount++; }
+
+class TestClassMoveOnly
+{
+public:
+	void MemberFuncUniquePtr(std::unique_ptr<StructParam> s, INT i) { ASSERT_TRUE(s->val == TEST_INT && i == TEST_INT); moveOnlyCount++; }
+	void MemberFuncVector(std::vector<INT> v) { ASSERT_TRUE(v.data() == moveOnlyData); moveOnlyCount++; }
+};
+
+std::unique_ptr<StructParam> MakeStructParam()
+{
+	std::unique_ptr<StructParam> s(new StructParam());
+	s->val = TEST_INT;
+	return s;
+}
+
+void MoveOnlyArgsTests()
+{
+	TestClassMoveOnly testClass;
+	std::shared_ptr<TestClassMoveOnly> testClassSp(new TestClassMoveOnly());
+	moveOnlyCount = 0;
+
+	auto FreeFuncUniquePtrDelegate = MakeDelegate(&FreeFuncUniquePtr, testThread);
+	FreeFuncUniquePtrDelegate(MakeStructParam());
+
+	auto MemberFuncUniquePtrDelegate = MakeDelegate(&testClass, &TestClassMoveOnly::MemberFuncUniquePtr, testThread);
+	MemberFuncUniquePtrDelegate(MakeStructParam(), TEST_INT);
+
+	auto MemberFuncUniquePtrSpDelegate = MakeDelegate(testClassSp, &TestClassMoveOnly::MemberFuncUniquePtr, testThread);
+	MemberFuncUniquePtrSpDelegate(MakeStructParam(), TEST_INT);
+
+	FreeFuncUniquePtrDelegate.SetInlineDispatch(true);
+	FreeFuncUniquePtrDelegate(MakeStructParam());
+
+	// Large payloads travel to the target without a deep copy. Each call waits for 
+	// the prior one so moveOnlyData identifies the buffer in flight.
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	auto FreeFuncVectorRvalueDelegate = MakeDelegate(&FreeFuncVectorRvalue, testThread);
+	std::vector<INT> frame(100000, TEST_INT);
+	moveOnlyData = frame.data();
+	FreeFuncVectorRvalueDelegate(std::move(frame));
+	FreeFunc0Delegate();
+
+	FreeFuncVectorRvalueDelegate.SetInlineDispatch(true);
+	std::vector<INT> frame2(100000, TEST_INT);
+	moveOnlyData = frame2.data();
+	FreeFuncVectorRvalueDelegate(std::move(frame2));
+	FreeFunc0Delegate();
+
+	auto MemberFuncVectorDelegate = MakeDelegate(&testClass, &TestClassMoveOnly::MemberFuncVector, testThread);
+	std::vector<INT> frame3(100000, TEST_INT);
+	moveOnlyData = frame3.data();
+	MemberFuncVectorDelegate(std::move(frame3));
+	FreeFunc0Delegate();
+
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(moveOnlyCount == 7);
+}
+
+static INT batchLastSeq = -1;
+static std::atomic<INT> batchCount(0);
+
+void FreeFuncBatch(INT seq, const StructParam& s) 
+{ 
+	// A batch is invoked in order
+	ASSERT_TRUE(batchLastSeq + 1 == seq); 
+	ASSERT_TRUE(s.val == TEST_INT);
+	batchLastSeq = seq; 
+	batchCount++; 
+}
+
+class TestClassBatch
+{
+public:
+	void MemberFuncUniquePtr(std::unique_ptr<StructParam> s) { ASSERT_TRUE(s->val == TEST_INT); batchCount++; }
+};
+
+template <class TThread>
+void InvokeBatchTests(TThread& thread)
+{
+	const INT BATCH = 50;
+	StructParam structParam;
+	structParam.val = TEST_INT;
+	TestClassBatch testClass;
+	std::shared_ptr<TestClassBatch> testClassSp(new TestClassBatch());
+	batchLastSeq = -1;
+	batchCount = 0;
+
+	auto FreeFuncBatchDelegate = MakeDelegate(&FreeFuncBatch, thread);
+	std::vector<std::tuple<INT, const StructParam&>> calls;
+	for (INT i = 0; i < BATCH; i++)
+		calls.emplace_back(i, structParam);
+	FreeFuncBatchDelegate.InvokeBatch(calls);
+
+	FreeFuncBatchDelegate.SetInlineDispatch(true);
+	calls.clear();
+	for (INT i = BATCH; i < BATCH * 2; i++)
+		calls.emplace_back(i, structParam);
+	FreeFuncBatchDelegate.InvokeBatch(calls);
+
+	// Move-only arguments are moved from the batch into the messages
+	auto MemberFuncDelegate = MakeDelegate(&testClass, &TestClassBatch::MemberFuncUniquePtr, thread);
+	std::vector<std::tuple<std::unique_ptr<StructParam>>> ptrCalls;
+	for (INT i = 0; i < BATCH; i++)
+		ptrCalls.emplace_back(MakeStructParam());
+	MemberFuncDelegate.InvokeBatch(std::move(ptrCalls));
+
+	auto MemberFuncSpDelegate = MakeDelegate(testClassSp, &TestClassBatch::MemberFuncUniquePtr, thread);
+	ptrCalls.clear();
+	for (INT i = 0; i < BATCH; i++)
+		ptrCalls.emplace_back(MakeStructParam());
+	MemberFuncSpDelegate.InvokeBatch(std::move(ptrCalls));
+
+	// An empty batch is allowed
+	MemberFuncSpDelegate.InvokeBatch({});
+
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, thread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(batchCount == BATCH * 4);
+}
+
+#if USE_STD_THREADS
+void SpinCountTests()
+{
+	// A spinning worker still runs every message in order
+	WorkerThread spinThread("SpinCountTestsThread");
+	ASSERT_TRUE(spinThread.GetSpinCount() == 0);
+	spinThread.SetSpinCount(100);
+	ASSERT_TRUE(spinThread.GetSpinCount() == 100);
+	spinThread.CreateThread();
+	InvokeBatchTests(spinThread);
+	spinThread.ExitThread();
+}
+
+static const INT MPSC_PRODUCERS = 4;
+static std::atomic<INT> mpscCount(0);
+static INT mpscLastSeq[MPSC_PRODUCERS];
+
+void FreeFuncMpsc(INT producer, INT seq) 
+{ 
+	// Messages from a single producer must arrive in order
+	ASSERT_TRUE(mpscLastSeq[producer] + 1 == seq); 
+	mpscLastSeq[producer] = seq; 
+	mpscCount++; 
+}
+
+void WorkerThreadMpscTests()
+{
+	const INT MSGS = 250;
+	mpscCount = 0;
+	for (INT p = 0; p < MPSC_PRODUCERS; p++)
+		mpscLastSeq[p] = -1;
+
+	// Post from several threads at once onto the lock-free queue
+	std::vector<std::thread> producers;
+	for (INT p = 0; p < MPSC_PRODUCERS; p++)
+	{
+		producers.emplace_back([p, MSGS]() {
+			auto delegate = MakeDelegate(&FreeFuncMpsc, testThreadMpsc);
+			for (INT i = 0; i < MSGS; i++)
+				delegate(p, i);
+		});
+	}
+	for (auto& producer : producers)
+		producer.join();
+
+	// A blocking call is queued behind all prior messages
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThreadMpsc, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(FreeFunc0Delegate.IsSuccess());
+	ASSERT_TRUE(mpscCount == MPSC_PRODUCERS * MSGS);
+}
+
+static std::atomic<INT> poolCount(0);
+static WorkerThreadPool* testPool = nullptr;
+
+void FreeFuncPool(INT i) { ASSERT_TRUE(testPool->IsPoolThread()); poolCount += i; }
+void FreeFuncPoolNested(INT i) 
+{ 
+	// A callback dispatching onto its own pool
+	MakeDelegate(&FreeFuncPool, *testPool)(i); 
+}
+
+void WorkerThreadPoolTests()
+{
+	const INT MSGS = 200;
+	WorkerThreadPool pool("DelegateUnitTestsPool", 4);
+	ASSERT_TRUE(pool.GetThreadCount() == 4);
+	ASSERT_TRUE(!pool.IsPoolThread());
+	pool.CreateThread();
+	testPool = &pool;
+	poolCount = 0;
+
+	auto delegate = MakeDelegate(&FreeFuncPool, pool);
+	auto inlineDelegate = MakeDelegate(&FreeFuncPool, pool);
+	inlineDelegate.SetInlineDispatch(true);
+	std::vector<std::tuple<INT>> calls(MSGS, std::tuple<INT>(1));
+	for (INT i = 0; i < MSGS; i++)
+	{
+		delegate(1);
+		inlineDelegate(1);
+	}
+	delegate.InvokeBatch(calls);
+	inlineDelegate.InvokeBatch(calls);
+	MakeDelegate(&FreeFuncPoolNested, pool)(MSGS);
+
+	// A blocking call completes on any worker, so wait for the count instead
+	auto start = Timer::GetTime();
+	while (poolCount != MSGS * 5 && Timer::Difference(start, Timer::GetTime()) < std::chrono::milliseconds(5000))
+		std::this_thread::yield();
+	ASSERT_TRUE(poolCount == MSGS * 5);
+
+	// Exiting invokes every message already dispatched
+	for (INT i = 0; i < MSGS; i++)
+		delegate(1);
+	pool.ExitThread();
+	ASSERT_TRUE(poolCount == MSGS * 6);
+	testPool = nullptr;
+}
+
+static const INT STRANDS = 8;
+static std::atomic<WorkerStrand*> strands[STRANDS];
+static INT strandLastSeq[STRANDS];
+static std::atomic<INT> strandActive[STRANDS];
+static std::atomic<INT> strandCount(0);
+
+void FreeFuncStrand(INT strand, INT seq) 
+{ 
+	// Messages on one strand never overlap and run in the order dispatched
+	ASSERT_TRUE(strandActive[strand]++ == 0);
+	WorkerStrand* current = strands[strand];
+	ASSERT_TRUE(current == nullptr || current->IsCurrent());
+	ASSERT_TRUE(seq == strandLastSeq[strand] + 1);
+	strandLastSeq[strand] = seq;
+	strandCount++;
+	strandActive[strand]--;
+}
+
+void WorkerStrandTests()
+{
+	const INT MSGS = 100;
+	WorkerThreadPool pool("DelegateUnitTestsStrandPool", 4);
+	pool.CreateThread();
+	strandCount = 0;
+
+	std::vector<std::unique_ptr<WorkerStrand>> owned;
+	for (INT s = 0; s < STRANDS; s++)
+	{
+		owned.emplace_back(new WorkerStrand(pool));
+		strands[s] = owned.back().get();
+		owned.back()->SetBatchSize(s + 1);
+		strandLastSeq[s] = -1;
+		strandActive[s] = 0;
+		ASSERT_TRUE(!owned.back()->IsCurrent());
+	}
+
+	// One producer thread per strand, mixing heap, inline and batch dispatch
+	std::vector<std::thread> producers;
+	for (INT s = 0; s < STRANDS; s++)
+	{
+		producers.emplace_back([s, MSGS]() {
+			auto delegate = MakeDelegate(&FreeFuncStrand, *strands[s]);
+			auto inlineDelegate = MakeDelegate(&FreeFuncStrand, *strands[s]);
+			inlineDelegate.SetInlineDispatch(true);
+			std::vector<std::tuple<INT, INT>> calls;
+			for (INT i = 0; i < MSGS; i++)
+			{
+				if (i % 3 == 0)
+					delegate(s, i);
+				else if (i % 3 == 1)
+					inlineDelegate(s, i);
+				else
+					calls.emplace_back(s, i);
+				if (i % 3 == 2)
+				{
+					delegate.InvokeBatch(calls);
+					calls.clear();
+				}
+			}
+		});
+	}
+	for (auto& producer : producers)
+		producer.join();
+
+	auto start = Timer::GetTime();
+	while (strandCount != STRANDS * MSGS && Timer::Difference(start, Timer::GetTime()) < std::chrono::milliseconds(5000))
+		std::this_thread::yield();
+	ASSERT_TRUE(strandCount == STRANDS * MSGS);
+
+	// A blocking call on a strand waits for prior messages
+	strandLastSeq[0] = -1;
+	for (INT i = 0; i < MSGS; i++)
+		MakeDelegate(&FreeFuncStrand, *strands[0])(0, i);
+	MakeDelegate(&FreeFunc0, *strands[0], WAIT_INFINITE)();
+	ASSERT_TRUE(strandLastSeq[0] == MSGS - 1);
+
+	// Messages still run after their strand is destroyed
+	strandLastSeq[1] = -1;
+	auto orphan = MakeDelegate(&FreeFuncStrand, *owned[1]);
+	strands[1] = nullptr;
+	for (INT i = 0; i < MSGS; i++)
+		orphan(1, i);
+	owned[1].reset();
+	pool.ExitThread();
+	ASSERT_TRUE(strandLastSeq[1] == MSGS - 1);
+
+	// A strand on a single worker thread
+	WorkerStrand threadStrand(testThread);
+	strands[2] = &threadStrand;
+	strandLastSeq[2] = -1;
+	for (INT i = 0; i < MSGS; i++)
+		MakeDelegate(&FreeFuncStrand, threadStrand)(2, i);
+	MakeDelegate(&FreeFunc0, threadStrand, WAIT_INFINITE)();
+	ASSERT_TRUE(strandLastSeq[2] == MSGS - 1);
+	for (INT s = 0; s < STRANDS; s++)
+		strands[s] = nullptr;
+}
+
+static std::vector<INT> priorityOrder;
+static std::atomic<bool> priorityGateEntered(false);
+static std::atomic<bool> priorityGateRelease(false);
+
+void FreeFuncPriority(INT i) { priorityOrder.push_back(i); }
+void FreeFuncPriorityGate() 
+{ 
+	// Hold the worker so messages queue up behind the gate
+	priorityGateEntered = true;
+	while (!priorityGateRelease)
+		std::this_thread::yield();
+}
+
+static void PriorityGate(WorkerThread& thread)
+{
+	priorityGateEntered = false;
+	priorityGateRelease = false;
+	MakeDelegate(&FreeFuncPriorityGate, thread)();
+	while (!priorityGateEntered)
+		std::this_thread::yield();
+}
+
+static void PriorityRelease(WorkerThread& thread)
+{
+	priorityGateRelease = true;
+
+	// Queued behind every other message
+	DelegatePriorityScope scope(DelegatePriority::LOW);
+	MakeDelegate(&FreeFunc0, thread, WAIT_INFINITE)();
+}
+
+/// A DelegateThread relying on the default DispatchDelegateInline()
+class ForwardingThread : public DelegateThread
+{
+public:
+	explicit ForwardingThread(WorkerThread& thread) : m_thread(thread) {}
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateMsgBase> msg) override { return m_thread.DispatchDelegate(msg); }
+private:
+	WorkerThread& m_thread;
+};
+
+void PriorityTests()
+{
+	WorkerThread thread("DelegateUnitTestsPriorityThread");
+	thread.CreateThread();
+
+	auto low = MakeDelegate(&FreeFuncPriority, thread);
+	low.SetPriority(DelegatePriority::LOW);
+	auto normal = MakeDelegate(&FreeFuncPriority, thread);
+	auto high = MakeDelegate(&FreeFuncPriority, thread);
+	high.SetPriority(DelegatePriority::HIGH);
+	high.SetInlineDispatch(true);
+	ASSERT_TRUE(high.GetPriority() == DelegatePriority::HIGH);
+	ASSERT_TRUE(normal.GetPriority() == DelegatePriority::NORMAL);
+
+	// Highest priority first, and in order within a priority
+	priorityOrder.clear();
+	PriorityGate(thread);
+	low(0);
+	normal(10);
+	high(20);
+	low(1);
+	high(21);
+	normal.InvokeBatch({ std::make_tuple(11), std::make_tuple(12) });
+	{
+		// A scope overrides the delegate priority for a single call
+		DelegatePriorityScope scope(DelegatePriority::HIGH);
+		low(22);
+	}
+	low(2);
+	PriorityRelease(thread);
+	const std::vector<INT> expected = { 20, 21, 22, 10, 11, 12, 0, 1, 2 };
+	ASSERT_TRUE(priorityOrder == expected);
+
+	// A multicast invocation within a scope
+	MulticastDelegate<void(INT)> multicast;
+	multicast += low;
+	multicast += normal;
+	priorityOrder.clear();
+	PriorityGate(thread);
+	normal(10);
+	{
+		DelegatePriorityScope scope(DelegatePriority::HIGH);
+		multicast(20);
+	}
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 20, 20, 10 }));
+
+	// The default inline dispatch keeps the message priority
+	ForwardingThread forwarding(thread);
+	auto forwarded = MakeDelegate(&FreeFuncPriority, forwarding);
+	forwarded.SetPriority(DelegatePriority::HIGH);
+	forwarded.SetInlineDispatch(true);
+	priorityOrder.clear();
+	PriorityGate(thread);
+	normal(10);
+	forwarded(20);
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 20, 10 }));
+
+	// Anti-starvation invokes a low priority message after every 2 passes
+	thread.SetStarvationLimit(2);
+	ASSERT_TRUE(thread.GetStarvationLimit() == 2);
+	priorityOrder.clear();
+	PriorityGate(thread);
+	low(0);
+	low(1);
+	for (INT i = 20; i < 26; i++)
+		high(i);
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 20, 21, 0, 22, 23, 1, 24, 25 }));
+
+	// Messages dispatched before the exit request are invoked, not promoted past
+	thread.SetStarvationLimit(1);
+	priorityOrder.clear();
+	PriorityGate(thread);
+	normal(10);
+	normal(11);
+	normal(12);
+	high(20);
+	high(21);
+	std::thread exiter([&thread]() { thread.ExitThread(); });
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	priorityGateRelease = true;
+	exiter.join();
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 20, 10, 21, 11, 12 }));
+}
+
+static void BoundedRelease(WorkerThread& thread)
+{
+	priorityGateRelease = true;
+
+	// A full queue may reject the wait message, so retry until it runs behind the rest
+	DelegatePriorityScope scope(DelegatePriority::LOW);
+	auto wait = MakeDelegate(&FreeFunc0, thread, WAIT_INFINITE);
+	while (!wait.AsyncInvoke())
+		std::this_thread::yield();
+}
+
+static std::atomic<bool> boundedGateRelease(false);
+
+void FreeFuncBoundedGate()
+{
+	priorityGateEntered = true;
+	while (!boundedGateRelease)
+		std::this_thread::yield();
+}
+
+/// Hold the worker in the priority gate with a second gate queued behind it
+static void BoundedGate(WorkerThread& thread)
+{
+	PriorityGate(thread);
+	boundedGateRelease = false;
+	MakeDelegate(&FreeFuncBoundedGate, thread)();
+}
+
+/// Release the priority gate. The worker takes every queued message, then holds in
+/// the second gate.
+static void BoundedGateRefill()
+{
+	priorityGateEntered = false;
+	priorityGateRelease = true;
+	while (!priorityGateEntered)
+		std::this_thread::yield();
+}
+
+static void BoundedQueueRestart(WorkerThread& thread, size_t capacity, WorkerThread::OverflowPolicy policy,
+	std::chrono::milliseconds timeout = std::chrono::milliseconds(0))
+{
+	thread.ExitThread();
+	thread.SetQueueCapacity(capacity, policy, timeout);
+	thread.CreateThread();
+}
+
+void BoundedQueueTests()
+{
+	// The gate message being invoked counts against the capacity, leaving room for 3
+	const size_t CAPACITY = 4;
+	WorkerThread thread("DelegateUnitTestsBoundedThread");
+	thread.CreateThread();
+	ASSERT_TRUE(thread.GetQueueCapacity() == 0);
+
+	auto normal = MakeDelegate(&FreeFuncPriority, thread);
+	auto high = MakeDelegate(&FreeFuncPriority, thread);
+	high.SetPriority(DelegatePriority::HIGH);
+
+	// Drop newest rejects, and a rejected wait delegate does not block
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	ASSERT_TRUE(thread.GetQueueCapacity() == CAPACITY);
+	ASSERT_TRUE(thread.GetOverflowPolicy() == WorkerThread::OverflowPolicy::DROP_NEWEST);
+	size_t dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	ASSERT_TRUE(normal.AsyncInvoke(0));
+	ASSERT_TRUE(normal.AsyncInvoke(1));
+	ASSERT_TRUE(normal.InvokeBatch({ std::make_tuple(2), std::make_tuple(3) }) == 1);
+	ASSERT_TRUE(!high.AsyncInvoke(20));
+	auto wait = MakeDelegate(&FreeFunc0, thread, WAIT_INFINITE);
+	ASSERT_TRUE(!wait.AsyncInvoke().has_value());
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 3);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 1, 2 }));
+
+	// Drop oldest discards the oldest message of equal or lower priority
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::DROP_OLDEST);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 5; i++)
+		ASSERT_TRUE(normal.AsyncInvoke(i));
+	ASSERT_TRUE(high.AsyncInvoke(20));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 3);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 20, 3, 4 }));
+
+	// Coalesce replaces the newest queued message with the same key in place
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::COALESCE);
+	auto streamA = MakeDelegate(&FreeFuncPriority, thread);
+	streamA.SetCoalesceKey(&streamA);
+	auto streamB = MakeDelegate(&FreeFuncPriority, thread);
+	streamB.SetCoalesceKey(&streamB);
+	streamB.SetInlineDispatch(true);
+	ASSERT_TRUE(streamA.GetCoalesceKey() == &streamA);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	streamA(0);
+	streamB(10);
+	streamA(1);
+	ASSERT_TRUE(streamA.AsyncInvoke(2));
+	ASSERT_TRUE(streamB.AsyncInvoke(11));
+	ASSERT_TRUE(!normal.AsyncInvoke(99));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 3);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 11, 2 }));
+
+	// Block with timeout rejects once the timeout expires
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::BLOCK_TIMEOUT, std::chrono::milliseconds(2));
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 3; i++)
+		normal(i);
+	ASSERT_TRUE(!normal.AsyncInvoke(3));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 1);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 1, 2 }));
+
+	// Block waits until the worker makes room
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::BLOCK);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 3; i++)
+		normal(i);
+	std::atomic<bool> posted(false);
+	std::thread producer([&]() {
+		ASSERT_TRUE(normal.AsyncInvoke(3));
+		posted = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	ASSERT_TRUE(!posted);
+	priorityGateRelease = true;
+	producer.join();
+	ASSERT_TRUE(posted);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 1, 2, 3 }));
+	ASSERT_TRUE(thread.GetDroppedCount() == dropped);
+
+	// Drop oldest and coalesce also discard messages the worker took from the queue
+	// but has not started. The second gate holds the worker just after a refill.
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::DROP_OLDEST);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	BoundedGate(thread);
+	normal(20);
+	normal(21);
+	BoundedGateRefill();
+	for (INT i = 30; i < 33; i++)
+		ASSERT_TRUE(normal.AsyncInvoke(i));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 2);
+	boundedGateRelease = true;
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 30, 31, 32 }));
+
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::COALESCE);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	BoundedGate(thread);
+	streamA(0);
+	normal(5);
+	BoundedGateRefill();
+	normal(6);
+	ASSERT_TRUE(streamA.AsyncInvoke(1));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == 1);
+	boundedGateRelease = true;
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 1, 5, 6 }));
+
+	// Dispatchers blocked for room when the thread exits are rejected. The exit request
+	// is queued behind the low priority messages, so the producers cannot all fit.
+	const INT PRODUCERS = 12;
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::BLOCK);
+	auto low = MakeDelegate(&FreeFuncPriority, thread);
+	low.SetPriority(DelegatePriority::LOW);
+	dropped = thread.GetDroppedCount();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 3; i++)
+		low(i);
+	std::atomic<INT> rejected(0);
+	std::vector<std::thread> producers;
+	for (INT i = 0; i < PRODUCERS; i++)
+	{
+		producers.emplace_back([&low, &rejected, i]() {
+			if (!low.AsyncInvoke(10 + i))
+				rejected++;
+		});
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	std::thread releaser([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		priorityGateRelease = true;
+	});
+	thread.ExitThread();
+	releaser.join();
+	for (auto& producer : producers)
+		producer.join();
+	ASSERT_TRUE(rejected >= PRODUCERS - 2 * static_cast<INT>(CAPACITY));
+	ASSERT_TRUE(thread.GetDroppedCount() - dropped == static_cast<size_t>(rejected.load()));
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 1, 2 }));
+	thread.CreateThread();
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder.size() <= 3 + static_cast<size_t>(PRODUCERS - rejected));
+
+	// A strand whose drain task is rejected by a full executor discards its messages
+	BoundedQueueRestart(thread, CAPACITY, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	WorkerStrand strand(thread);
+	auto onStrand = MakeDelegate(&FreeFuncPriority, strand);
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 3; i++)
+		normal(i);
+	ASSERT_TRUE(!onStrand.AsyncInvoke(50));
+	ASSERT_TRUE(onStrand.InvokeBatch({ std::make_tuple(51), std::make_tuple(52) }) == 0);
+	BoundedRelease(thread);
+	ASSERT_TRUE(onStrand.AsyncInvoke(53));
+	MakeDelegate(&FreeFunc0, strand, WAIT_INFINITE)();
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 1, 2, 53 }));
+
+	// A blocking call is invoked on the calling thread rather than discarded
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 3; i++)
+		normal(i);
+	auto waitOnStrand = MakeDelegate(&FreeFuncPriority, strand, WAIT_INFINITE);
+	ASSERT_TRUE(waitOnStrand.AsyncInvoke(54).has_value());
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 54 }));
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 54, 0, 1, 2 }));
+
+	thread.ExitThread();
+}
+
+class ConflateTarget
+{
+public:
+	void SetMode(const std::string& mode) { modes.push_back(mode); }
+	std::vector<std::string> modes;
+};
+
+void ConflateTests()
+{
+	WorkerThread thread("DelegateUnitTestsConflateThread");
+	thread.CreateThread();
+
+	auto latest = MakeDelegate(&FreeFuncPriority, thread);
+	ASSERT_TRUE(!latest.GetConflate());
+	latest.SetConflate(true);
+	ASSERT_TRUE(latest.GetConflate());
+
+	// Posts while a message is queued replace its arguments
+	priorityOrder.clear();
+	PriorityGate(thread);
+	for (INT i = 0; i < 10; i++)
+		ASSERT_TRUE(latest.AsyncInvoke(i));
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 9 }));
+
+	// Once invoked, the next post queues a new message
+	latest(10);
+	MakeDelegate(&FreeFunc0, thread, WAIT_INFINITE)();
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 9, 10 }));
+
+	// Copies, batches and multicast invocations share one pending message
+	MulticastDelegate<void(INT)> multicast;
+	multicast += latest;
+	priorityOrder.clear();
+	PriorityGate(thread);
+	latest(0);
+	ASSERT_TRUE(latest.InvokeBatch({ std::make_tuple(1), std::make_tuple(2) }) == 2);
+	multicast(3);
+	multicast.Broadcast(4);
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 4 }));
+
+	// Member function with a reference argument copied into the pending slot
+	ConflateTarget target;
+	auto mode = MakeDelegate(&target, &ConflateTarget::SetMode, thread);
+	mode.SetConflate(true);
+	PriorityGate(thread);
+	{
+		std::string value = "STARTING";
+		mode(value);
+		value = "NORMAL";
+		mode(value);
+	}
+	PriorityRelease(thread);
+	ASSERT_TRUE(target.modes == std::vector<std::string>({ "NORMAL" }));
+
+	// A rejected message does not leave the slot pending
+	thread.ExitThread();
+	thread.SetQueueCapacity(2, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	thread.CreateThread();
+	auto other = MakeDelegate(&FreeFuncPriority, thread);
+	priorityOrder.clear();
+	PriorityGate(thread);
+	other(0);
+	ASSERT_TRUE(!latest.AsyncInvoke(1));
+	BoundedRelease(thread);
+	ASSERT_TRUE(latest.AsyncInvoke(2));
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 0, 2 }));
+
+	// Nor does a queued message the queue discards
+	thread.ExitThread();
+	thread.SetQueueCapacity(2, WorkerThread::OverflowPolicy::DROP_OLDEST);
+	thread.CreateThread();
+	priorityOrder.clear();
+	PriorityGate(thread);
+	latest(1);
+	other(0);
+	latest(2);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 2 }));
+
+	thread.ExitThread();
+}
+
+INT FreeFuncFuture(INT i) { priorityOrder.push_back(i); return i * 2; }
+
+static std::atomic<INT> futureResult(0);
+void FreeFuncFutureResult(std::optional<INT> result) { futureResult = result.value_or(-1); }
+
+class FutureTarget
+{
+public:
+	std::string Echo(const std::string& s) const { return s + "!"; }
+	void Reset(std::unique_ptr<StructParam> s) { ASSERT_TRUE(s && s->val == TEST_INT); resets++; }
+	INT resets = 0;
+};
+
+void FutureTests()
+{
+	WorkerThread thread("DelegateUnitTestsFutureThread");
+	thread.CreateThread();
+
+	auto twice = MakeDelegate(&FreeFuncFuture, thread, WAIT_INFINITE);
+	ASSERT_TRUE(!DelegateFuture<INT>().IsValid());
+
+	// The caller returns before the target runs and polls for the result
+	priorityOrder.clear();
+	PriorityGate(thread);
+	auto future = twice.AsyncInvokeFuture(21);
+	ASSERT_TRUE(future.IsValid());
+	ASSERT_TRUE(!future.IsReady());
+	ASSERT_TRUE(!future.WaitFor(std::chrono::milliseconds(1)));
+	priorityGateRelease = true;
+	while (!future.IsReady())
+		std::this_thread::yield();
+	ASSERT_TRUE(future.Get() == 42);
+	ASSERT_TRUE(future.Get() == 42);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 21 }));
+
+	// Requests to several threads overlap, and results are collected later
+	WorkerThread thread2("DelegateUnitTestsFutureThread2");
+	thread2.CreateThread();
+	FutureTarget target;
+	auto echo = MakeDelegate(&target, &FutureTarget::Echo, thread2, WAIT_INFINITE);
+	auto reset = MakeDelegate(&target, &FutureTarget::Reset, thread2, WAIT_INFINITE);
+	auto futureEcho = echo.AsyncInvokeFuture(std::string("hello"));
+	auto futureReset = reset.AsyncInvokeFuture(std::make_unique<StructParam>(StructParam{ TEST_INT }));
+	auto futureTwice = twice.AsyncInvokeFuture(5);
+	ASSERT_TRUE(futureTwice.WaitFor(WAIT_INFINITE));
+	ASSERT_TRUE(futureTwice.Get() == 10);
+	ASSERT_TRUE(futureEcho.Get() == std::string("hello!"));
+	ASSERT_TRUE(futureReset.Get() == true);
+	ASSERT_TRUE(target.resets == 1);
+
+	// A continuation runs on the target thread, or at once if already complete
+	std::atomic<INT> continued(0);
+	PriorityGate(thread);
+	future = twice.AsyncInvokeFuture(1);
+	future.Then([&](std::optional<INT> result) {
+		ASSERT_TRUE(result == 2);
+		ASSERT_TRUE(std::this_thread::get_id() == thread.GetThreadId());
+		continued++;
+	});
+	ASSERT_TRUE(continued == 0);
+	PriorityRelease(thread);
+	ASSERT_TRUE(continued == 1);
+	future = twice.AsyncInvokeFuture(2);
+	future.Wait();
+	future.Then([&](std::optional<INT> result) { ASSERT_TRUE(result == 4); continued++; });
+	ASSERT_TRUE(continued == 2);
+
+	// An asynchronous delegate continuation runs on its own thread
+	futureResult = 0;
+	twice.AsyncInvokeFuture(3).Then(MakeDelegate(&FreeFuncFutureResult, thread2));
+	while (futureResult == 0)
+		std::this_thread::yield();
+	ASSERT_TRUE(futureResult == 6);
+
+	// A rejected or discarded message fails the future
+	thread.ExitThread();
+	thread.SetQueueCapacity(2, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	thread.CreateThread();
+	PriorityGate(thread);
+	auto first = twice.AsyncInvokeFuture(1);
+	auto rejected = twice.AsyncInvokeFuture(2);
+	ASSERT_TRUE(rejected.IsReady());
+	ASSERT_TRUE(!rejected.Get().has_value());
+	BoundedRelease(thread);
+	ASSERT_TRUE(first.Get() == 2);
+	thread.ExitThread();
+	thread.SetQueueCapacity(2, WorkerThread::OverflowPolicy::DROP_OLDEST);
+	thread.CreateThread();
+	PriorityGate(thread);
+	auto discarded = twice.AsyncInvokeFuture(1);
+	auto kept = twice.AsyncInvokeFuture(2);
+	ASSERT_TRUE(!discarded.Get().has_value());
+	BoundedRelease(thread);
+	ASSERT_TRUE(kept.Get() == 4);
+
+	thread2.ExitThread();
+	thread.ExitThread();
+}
+
+INT FreeFuncTwice(INT i) { return i * 2; }
+
+void WhenAllAnyTests()
+{
+	const INT THREADS = 3;
+	WorkerThread threads[THREADS] = { "DelegateUnitTestsWhenThread0", "DelegateUnitTestsWhenThread1", "DelegateUnitTestsWhenThread2" };
+	std::vector<DelegateFreeAsyncWait<INT(INT)>> twice;
+	for (auto& thread : threads)
+	{
+		thread.CreateThread();
+		twice.push_back(MakeDelegate(&FreeFuncTwice, thread, WAIT_INFINITE));
+	}
+	ASSERT_TRUE(WhenAll(std::vector<DelegateFuture<INT>>(), WAIT_INFINITE).empty());
+	ASSERT_TRUE(WhenAny(std::vector<DelegateFuture<INT>>(), WAIT_INFINITE).empty());
+
+	// Every result is gathered
+	std::vector<DelegateFuture<INT>> futures;
+	for (INT i = 0; i < THREADS; i++)
+		futures.push_back(twice[i].AsyncInvokeFuture(i));
+	auto results = WhenAll(futures, WAIT_INFINITE);
+	ASSERT_TRUE(results == std::vector<std::optional<INT>>({ 0, 2, 4 }));
+
+	// A blocked thread times out without delaying the other results
+	PriorityGate(threads[1]);
+	futures.clear();
+	for (INT i = 0; i < THREADS; i++)
+		futures.push_back(twice[i].AsyncInvokeFuture(i));
+	futures[0].Wait();
+	futures[2].Wait();
+	results = WhenAll(futures, std::chrono::milliseconds(2));
+	ASSERT_TRUE(results == std::vector<std::optional<INT>>({ 0, std::nullopt, 4 }));
+
+	// The first result returns while another thread is still blocked
+	futures[1] = twice[1].AsyncInvokeFuture(1);
+	futures[2] = twice[2].AsyncInvokeFuture(2);
+	results = WhenAny(std::vector<DelegateFuture<INT>>({ futures[1], futures[2] }), WAIT_INFINITE);
+	ASSERT_TRUE(results.size() == 2 && !results[0] && results[1] == 4);
+	results = WhenAny(std::vector<DelegateFuture<INT>>({ futures[1] }), std::chrono::milliseconds(2));
+	ASSERT_TRUE(results.size() == 1 && !results[0]);
+	PriorityRelease(threads[1]);
+	ASSERT_TRUE(WhenAny(std::vector<DelegateFuture<INT>>({ futures[1] }), WAIT_INFINITE)[0] == 2);
+
+	// Failed invocations do not count as the first result
+	threads[0].ExitThread();
+	threads[0].SetQueueCapacity(1, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	threads[0].CreateThread();
+	PriorityGate(threads[0]);
+	futures = { twice[0].AsyncInvokeFuture(0), twice[1].AsyncInvokeFuture(1) };
+	results = WhenAny(futures, WAIT_INFINITE);
+	ASSERT_TRUE(results == std::vector<std::optional<INT>>({ std::nullopt, 2 }));
+	futures.pop_back();
+	ASSERT_TRUE(WhenAny(futures, WAIT_INFINITE)[0] == std::nullopt);
+	BoundedRelease(threads[0]);
+
+	for (auto& thread : threads)
+		thread.ExitThread();
+}
+
+static std::atomic<INT> replyValue(0);
+static std::atomic<INT> replyCount(0);
+static std::atomic<INT> replyTimeoutCount(0);
+static WorkerThread* replyThread = nullptr;
+
+void FreeFuncReply(INT i) { ASSERT_TRUE(std::this_thread::get_id() == replyThread->GetThreadId()); replyValue = i; replyCount++; }
+void FreeFuncReplyVoid() { ASSERT_TRUE(std::this_thread::get_id() == replyThread->GetThreadId()); replyCount++; }
+void FreeFuncReplyTimeout() { ASSERT_TRUE(std::this_thread::get_id() == replyThread->GetThreadId()); replyTimeoutCount++; }
+
+class RequestServer
+{
+public:
+	INT Scale(INT i) const { return i * factor; }
+	INT factor = 3;
+};
+
+static void ReplyWait(INT replies, INT timeouts)
+{
+	while (replyCount + replyTimeoutCount < replies + timeouts)
+		std::this_thread::yield();
+	ASSERT_TRUE(replyCount == replies);
+	ASSERT_TRUE(replyTimeoutCount == timeouts);
+}
+
+void AsyncRequestTests()
+{
+	WorkerThread server("DelegateUnitTestsRequestServer");
+	WorkerThread client("DelegateUnitTestsRequestClient");
+	server.CreateThread();
+	client.CreateThread();
+	replyThread = &client;
+	replyCount = 0;
+	replyTimeoutCount = 0;
+
+	auto reply = MakeDelegate(&FreeFuncReply, client);
+	auto timeout = MakeDelegate(&FreeFuncReplyTimeout, client);
+	auto request = MakeDelegate(MakeDelegate(&FreeFuncTwice, server, std::chrono::milliseconds(5000)), reply, timeout);
+	ASSERT_TRUE(request.GetTimeout() == std::chrono::milliseconds(5000));
+
+	// The reply is posted to the client thread
+	ASSERT_TRUE(request.AsyncInvoke(21));
+	ReplyWait(1, 0);
+	ASSERT_TRUE(replyValue == 42);
+
+	// Member function and void requests, invoked through a multicast delegate
+	RequestServer target;
+	auto scale = MakeDelegate(MakeDelegate(&target, &RequestServer::Scale, server, WAIT_INFINITE), reply, timeout);
+	auto reset = MakeDelegate(MakeDelegate(&FreeFunc0, server, WAIT_INFINITE), MakeDelegate(&FreeFuncReplyVoid, client), timeout);
+	MulticastDelegate<void(INT)> multicast;
+	multicast += scale;
+	multicast(5);
+	ReplyWait(2, 0);
+	ASSERT_TRUE(replyValue == 15);
+	reset();
+	ReplyWait(3, 0);
+	std::unique_ptr<DelegateAsyncRequest<INT(INT)>> clone(scale.Clone());
+	ASSERT_TRUE(scale == *clone);
+	ASSERT_TRUE(!(scale == request));
+
+	// A blocked server times out, and the late result is dropped
+	auto quick = MakeDelegate(MakeDelegate(&FreeFuncTwice, server, std::chrono::milliseconds(2)), reply, timeout);
+	PriorityGate(server);
+	ASSERT_TRUE(quick.AsyncInvoke(1));
+	ReplyWait(3, 1);
+	PriorityRelease(server);
+	MakeDelegate(&FreeFunc0, client, WAIT_INFINITE)();
+	ASSERT_TRUE(replyCount == 3);
+
+	// A rejected request times out at once
+	server.ExitThread();
+	server.SetQueueCapacity(1, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	server.CreateThread();
+	PriorityGate(server);
+	ASSERT_TRUE(!request.AsyncInvoke(1));
+	ReplyWait(3, 2);
+	BoundedRelease(server);
+
+	server.ExitThread();
+	client.ExitThread();
+	replyThread = nullptr;
+}
+
+void SemaphoreTests()
+{
+	// A binary semaphore; signals do not accumulate
+	Semaphore sema;
+	ASSERT_TRUE(!sema.Wait(std::chrono::milliseconds(0)));
+	sema.Signal();
+	sema.Signal();
+	ASSERT_TRUE(sema.Wait(std::chrono::milliseconds(0)));
+	ASSERT_TRUE(!sema.Wait(std::chrono::milliseconds(1)));
+
+	// Parks immediately without spinning, then wakes on the signal
+	const int spinCount = Semaphore::GetSpinCount();
+	Semaphore::SetSpinCount(0);
+	std::thread signaler([&sema]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+		sema.Signal();
+	});
+	ASSERT_TRUE(sema.Wait(WAIT_INFINITE));
+	signaler.join();
+	Semaphore::SetSpinCount(spinCount);
+
+	// A released semaphore is reused by the thread, without a pending signal
+	Semaphore* pooled = nullptr;
+	{
+		auto slot = SemaphorePool::Acquire();
+		pooled = slot.get();
+		slot->Signal();
+	}
+	auto slot = SemaphorePool::Acquire();
+	ASSERT_TRUE(slot.get() == pooled);
+	ASSERT_TRUE(!slot->Wait(std::chrono::milliseconds(0)));
+	slot = nullptr;
+
+	// Blocking calls return the semaphore to the caller's pool, not the target thread's
+	WorkerThread thread("DelegateUnitTestsSemaphoreThread");
+	thread.CreateThread();
+	auto blocking = MakeDelegate(&FreeFuncTwice, thread, WAIT_INFINITE);
+	for (INT i = 0; i < 100; i++)
+	{
+		ASSERT_TRUE(blocking.AsyncInvoke(i) == i * 2);
+		slot = SemaphorePool::Acquire();
+		ASSERT_TRUE(slot.get() == pooled);
+		slot = nullptr;
+	}
+
+	// A caller thread exiting right after its call deletes its pooled semaphore, while
+	// the target thread may still be returning from Signal()
+	for (INT i = 0; i < 10; i++)
+	{
+		std::thread caller([&blocking, i]() { ASSERT_TRUE(blocking.AsyncInvoke(i) == i * 2); });
+		caller.join();
+	}
+
+	// A call that timed out signals its own semaphore late, without completing a later call
+	auto twice = MakeDelegate(&FreeFuncTwice, thread, std::chrono::milliseconds(1));
+	PriorityGate(thread);
+	ASSERT_TRUE(!twice.AsyncInvoke(1).has_value());
+	PriorityRelease(thread);
+	for (INT i = 0; i < 10; i++)
+	{
+		PriorityGate(thread);
+		ASSERT_TRUE(!twice.AsyncInvoke(i).has_value());
+		priorityGateRelease = true;
+		ASSERT_TRUE(MakeDelegate(&FreeFuncTwice, thread, WAIT_INFINITE).AsyncInvoke(i) == i * 2);
+	}
+	thread.ExitThread();
+}
+
+#if defined(__cpp_impl_coroutine)
+/// Minimal coroutine type that runs eagerly and destroys its frame when done
+struct TestCoroutine
+{
+	struct promise_type
+	{
+		TestCoroutine get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() { }
+		void unhandled_exception() { ASSERT(); }
+	};
+};
+
+static std::atomic<INT> coroutineDone(0);
+static WorkerThread* coroutineOrigin = nullptr;
+static WorkerThread* coroutineTarget = nullptr;
+
+void FreeFuncCoroutine(const std::string& s, INT& out) 
+{ 
+	ASSERT_TRUE(std::this_thread::get_id() == coroutineTarget->GetThreadId());
+	out = static_cast<INT>(s.size());
+}
+
+TestCoroutine CoroutineAwaits(WorkerThread& origin, WorkerThread& target)
+{
+	// Resumes on the original thread with the return value
+	ASSERT_TRUE(DelegateThreadScope::GetCurrent() == &origin);
+	auto twice = co_await AsyncAwait(MakeDelegate(&FreeFuncTwice, target, WAIT_INFINITE), 21);
+	ASSERT_TRUE(twice == 42);
+	ASSERT_TRUE(std::this_thread::get_id() == origin.GetThreadId());
+
+	// Reference arguments refer to the objects within the coroutine
+	INT length = 0;
+	auto done = co_await AsyncAwait(MakeDelegate(&FreeFuncCoroutine, target), "hello", length);
+	ASSERT_TRUE(done == true && length == 5);
+	ASSERT_TRUE(std::this_thread::get_id() == origin.GetThreadId());
+
+	RequestServer server;
+	auto scaled = co_await AsyncAwait(MakeDelegate(&server, &RequestServer::Scale, target, WAIT_INFINITE), 2);
+	ASSERT_TRUE(scaled == 6);
+	coroutineDone++;
+}
+
+TestCoroutine CoroutineRejected(WorkerThread& origin, WorkerThread& target)
+{
+	// A rejected dispatch resumes at once with an empty result
+	auto twice = co_await AsyncAwait(MakeDelegate(&FreeFuncTwice, target, WAIT_INFINITE), 1);
+	ASSERT_TRUE(!twice.has_value());
+	ASSERT_TRUE(std::this_thread::get_id() == origin.GetThreadId());
+	coroutineDone++;
+}
+
+void CoroutineStart(bool rejected)
+{
+	if (rejected)
+		CoroutineRejected(*coroutineOrigin, *coroutineTarget);
+	else
+		CoroutineAwaits(*coroutineOrigin, *coroutineTarget);
+}
+
+void CoroutineTests()
+{
+	WorkerThread origin("DelegateUnitTestsCoroutineOrigin");
+	WorkerThread target("DelegateUnitTestsCoroutineTarget");
+	origin.CreateThread();
+	target.CreateThread();
+	coroutineOrigin = &origin;
+	coroutineTarget = &target;
+	coroutineDone = 0;
+	ASSERT_TRUE(DelegateThreadScope::GetCurrent() == nullptr);
+
+	MakeDelegate(&CoroutineStart, origin)(false);
+	while (coroutineDone != 1)
+		std::this_thread::yield();
+
+	target.ExitThread();
+	target.SetQueueCapacity(1, WorkerThread::OverflowPolicy::DROP_NEWEST);
+	target.CreateThread();
+	PriorityGate(target);
+	MakeDelegate(&CoroutineStart, origin)(true);
+	while (coroutineDone != 2)
+		std::this_thread::yield();
+	BoundedRelease(target);
+
+	coroutineOrigin = nullptr;
+	coroutineTarget = nullptr;
+	target.ExitThread();
+	origin.ExitThread();
+}
+#endif
+#endif
+
+static std::atomic<INT> timerCount(0);
+static std::atomic<INT> timerSlowCount(0);
+
+void FreeFuncTimer()
+{
+#if USE_STD_THREADS
+	// Expired is dispatched to the owning thread, not run on the timer thread
+	ASSERT_TRUE(WorkerThread::GetCurrentThreadId() == testThread.GetThreadId());
+#endif
+	timerCount++;
+}
+void FreeFuncTimerSlow() { timerSlowCount++; }
+
+void TimerTests()
+{
+	timerCount = 0;
+	timerSlowCount = 0;
+
+	Timer timer;
+	ASSERT_TRUE(!timer.Enabled());
+	timer.Expired = MakeDelegate(&FreeFuncTimer, testThread);
+
+	// A timer with a far deadline must not delay one with a near deadline
+	Timer slowTimer;
+	slowTimer.Expired = MakeDelegate(&FreeFuncTimerSlow, testThread);
+	slowTimer.Start(std::chrono::milliseconds(60000));
+
+	timer.Start(std::chrono::milliseconds(1));
+	ASSERT_TRUE(timer.Enabled());
+	for (INT i = 0; i < 5000 && timerCount < 3; i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	ASSERT_TRUE(timerCount >= 3);
+	ASSERT_TRUE(timerSlowCount == 0);
+
+	// Restarting an enabled timer replaces its schedule
+	timer.Start(std::chrono::milliseconds(60000));
+	timer.Start(std::chrono::milliseconds(1));
+
+	// No callbacks are dispatched once Stop() returns
+	timer.Stop();
+	ASSERT_TRUE(!timer.Enabled());
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	INT count = timerCount;
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	FreeFunc0Delegate();
+	ASSERT_TRUE(timerCount == count);
+
+	// Destroying an enabled timer removes it from the timer service
+	{
+		Timer scopedTimer;
+		scopedTimer.Expired = MakeDelegate(&FreeFuncTimer, testThread);
+		scopedTimer.Start(std::chrono::milliseconds(1));
+	}
+	FreeFunc0Delegate();
+	count = timerCount;
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	FreeFunc0Delegate();
+	ASSERT_TRUE(timerCount == count);
+}
+
+static INT manualTimerCount = 0;
+static ManualTimerClock* manualClock = nullptr;
+static std::chrono::steady_clock::time_point manualTimerTimes[8];
+
+void FreeFuncManualTimer() { manualTimerTimes[manualTimerCount++ % 8] = manualClock->Now(); }
+
+void ManualTimerTests()
+{
+	using std::chrono::nanoseconds;
+	using std::chrono::microseconds;
+	using std::chrono::steady_clock;
+
+	ManualTimerClock clock;
+	manualClock = &clock;
+	manualTimerCount = 0;
+	ASSERT_TRUE(clock.Now() == steady_clock::time_point());
+
+	// Expired is invoked synchronously from Advance() at each 500us deadline
+	Timer timer(clock);
+	timer.Expired = MakeDelegate(&FreeFuncManualTimer);
+	timer.Start(microseconds(500));
+	clock.Advance(microseconds(499));
+	ASSERT_TRUE(manualTimerCount == 0);
+	clock.Advance(nanoseconds(1000));
+	ASSERT_TRUE(manualTimerCount == 1);
+	for (INT i = 0; i < 3; i++)
+		clock.Advance(microseconds(500));
+	ASSERT_TRUE(manualTimerCount == 4);
+	ASSERT_TRUE(manualTimerTimes[3] == steady_clock::time_point(microseconds(2000)));
+
+	// Late expirations do not push later deadlines back
+	clock.Advance(microseconds(700));
+	ASSERT_TRUE(manualTimerCount == 5);
+	clock.Advance(microseconds(299));
+	ASSERT_TRUE(manualTimerCount == 5);
+	clock.Advance(microseconds(1));
+	ASSERT_TRUE(manualTimerCount == 6);
+
+	// A timer more than one period behind fires once, then stays in phase
+	clock.Advance(microseconds(2200));
+	ASSERT_TRUE(manualTimerCount == 7);
+	clock.Advance(nanoseconds(299999));
+	ASSERT_TRUE(manualTimerCount == 7);
+	clock.Advance(nanoseconds(1));
+	ASSERT_TRUE(manualTimerCount == 8);
+	ASSERT_TRUE(manualTimerTimes[7] == steady_clock::time_point(microseconds(5500)));
+
+	// Timers expire in deadline order
+	Timer timer2(clock);
+	timer2.Expired = MakeDelegate(&FreeFuncManualTimer);
+	timer2.Start(microseconds(200));
+	for (INT i = 0; i < 6; i++)
+		clock.Advance(microseconds(100));
+	ASSERT_TRUE(manualTimerCount == 12);
+	ASSERT_TRUE(manualTimerTimes[0] == steady_clock::time_point(microseconds(5700)));
+	ASSERT_TRUE(manualTimerTimes[1] == steady_clock::time_point(microseconds(5900)));
+	ASSERT_TRUE(manualTimerTimes[2] == steady_clock::time_point(microseconds(6000)));
+	ASSERT_TRUE(manualTimerTimes[3] == steady_clock::time_point(microseconds(6100)));
+
+	timer.Stop();
+	timer2.Stop();
+	clock.Advance(microseconds(10000));
+	ASSERT_TRUE(manualTimerCount == 12);
+	manualClock = nullptr;
+}
+
+static std::vector<INT> slotOrder;
+
+void FreeFuncSlot(INT i) { slotOrder.push_back(i); }
+
+class TestClassSlot
+{
+public:
+	TestClassSlot(INT id) : m_id(id) {}
+	void MemberFuncSlot(INT i) { slotOrder.push_back(m_id); }
+private:
+	INT m_id;
+};
+
+void MulticastDelegateSlotTests()
+{
+	const INT SUBSCRIBERS = 100;
+	std::vector<std::shared_ptr<TestClassSlot>> objects;
+	for (INT i = 0; i < SUBSCRIBERS; i++)
+		objects.push_back(std::make_shared<TestClassSlot>(i));
+
+	// Mix delegates stored inline with a blocking delegate too large for a slot. 
+	// Growing the array relocates every slot.
+	MulticastDelegate<void(INT)> delegate;
+	for (INT i = 0; i < SUBSCRIBERS; i++)
+	{
+		if (i % 3 == 0)
+			delegate += MakeDelegate(objects[i], &TestClassSlot::MemberFuncSlot);
+		else if (i % 3 == 1)
+			delegate += MakeDelegate(objects[i].get(), &TestClassSlot::MemberFuncSlot);
+		else
+			delegate += MakeDelegate(objects[i].get(), &TestClassSlot::MemberFuncSlot, testThread, WAIT_INFINITE);
+	}
+	delegate += MakeDelegate(&FreeFuncSlot);
+
+	slotOrder.clear();
+	delegate(SUBSCRIBERS);
+	ASSERT_TRUE(slotOrder.size() == SUBSCRIBERS + 1);
+	for (INT i = 0; i <= SUBSCRIBERS; i++)
+		ASSERT_TRUE(slotOrder[i] == i);
+
+	// Removing from the front and middle keeps the remaining order
+	delegate -= MakeDelegate(objects[0], &TestClassSlot::MemberFuncSlot);
+	delegate -= MakeDelegate(objects[50].get(), &TestClassSlot::MemberFuncSlot, testThread, WAIT_INFINITE);
+	delegate -= MakeDelegate(objects[52].get(), &TestClassSlot::MemberFuncSlot);
+	slotOrder.clear();
+	delegate(SUBSCRIBERS);
+	ASSERT_TRUE(slotOrder.size() == SUBSCRIBERS - 2);
+	ASSERT_TRUE(slotOrder[0] == 1);
+	ASSERT_TRUE(slotOrder[48] == 49);
+	ASSERT_TRUE(slotOrder[49] == 51);
+	ASSERT_TRUE(slotOrder[50] == 53);
+	ASSERT_TRUE(slotOrder.back() == SUBSCRIBERS);
+
+	// The container holds its own reference to shared_ptr targets
+	std::weak_ptr<TestClassSlot> weak = objects[3];
+	objects.clear();
+	ASSERT_TRUE(!weak.expired());
+	delegate.Clear();
+	ASSERT_TRUE(weak.expired());
+	ASSERT_TRUE(!delegate);
+}
+
+static std::atomic<INT> valueCount(0);
+
+void FreeFuncValue(INT i) { ASSERT_TRUE(i == TEST_INT); valueCount++; }
+void FreeFuncValueStruct(const StructParam& s, StructParam* s2) { ASSERT_TRUE(s.val == TEST_INT && s2->val == TEST_INT); valueCount++; }
+
+void DelegateValueTests()
+{
+	static_assert(std::is_trivially_copyable<DelegateValue<void(INT)>>::value, "DelegateValue must be trivially copyable");
+
+	valueCount = 0;
+	TestClass1 testClass1;
+	TestClass1 testClass1b;
+
+	DelegateValue<void(INT)> empty;
+	ASSERT_TRUE(empty.Empty());
+	ASSERT_TRUE(!empty);
+
+	// Free, member and const member functions
+	DelegateValue freeDelegate(&FreeFuncValue);
+	DelegateValue memberDelegate(&testClass1, &TestClass1::MemberFuncInt1);
+	DelegateValue constDelegate(static_cast<const TestClass1*>(&testClass1), &TestClass1::MemberFuncInt1Const);
+	DelegateValue returnDelegate(&testClass1, &TestClass1::MemberFuncIntWithReturn1);
+	ASSERT_TRUE(freeDelegate && memberDelegate && constDelegate);
+	freeDelegate(TEST_INT);
+	memberDelegate(TEST_INT);
+	constDelegate(TEST_INT);
+	ASSERT_TRUE(returnDelegate(TEST_INT) == TEST_INT);
+	ASSERT_TRUE(valueCount == 1);
+
+	// Equality compares the bound function, object and thread
+	ASSERT_TRUE(freeDelegate == DelegateValue<void(INT)>(&FreeFuncValue));
+	ASSERT_TRUE(freeDelegate != DelegateValue<void(INT)>(&FreeFuncInt1));
+	ASSERT_TRUE(memberDelegate == DelegateValue<void(INT)>(&testClass1, &TestClass1::MemberFuncInt1));
+	ASSERT_TRUE(memberDelegate != DelegateValue<void(INT)>(&testClass1b, &TestClass1::MemberFuncInt1));
+	ASSERT_TRUE(memberDelegate != constDelegate);
+	ASSERT_TRUE(freeDelegate != DelegateValue<void(INT)>(&FreeFuncValue, testThread));
+	ASSERT_TRUE(freeDelegate != empty);
+
+	// Copies are independent values
+	DelegateValue<void(INT)> copy = memberDelegate;
+	ASSERT_TRUE(copy == memberDelegate);
+	copy.Clear();
+	ASSERT_TRUE(!copy && memberDelegate);
+	copy.Bind(&FreeFuncValue);
+	ASSERT_TRUE(copy == freeDelegate);
+
+	// Value delegates are stored by value, e.g. a vector as a multicast list
+	std::vector<DelegateValue<void(INT)>> delegates = { freeDelegate, memberDelegate, freeDelegate };
+	delegates.erase(std::find(delegates.begin(), delegates.end(), memberDelegate));
+	for (auto& delegate : delegates)
+		delegate(TEST_INT);
+	ASSERT_TRUE(valueCount == 3);
+
+	// Asynchronous delegates dispatch to the bound thread
+	DelegateValue asyncDelegate(&FreeFuncValue, testThread);
+	ASSERT_TRUE(asyncDelegate.GetThread() == &testThread);
+	asyncDelegate(TEST_INT);
+	DelegateValue asyncMemberDelegate(&testClass1, &TestClass1::MemberFuncInt1, testThread);
+	asyncMemberDelegate(TEST_INT);
+
+	// Pointer and reference arguments are copied into the message
+	StructParam structParam;
+	structParam.val = TEST_INT;
+	DelegateValue asyncStructDelegate(&FreeFuncValueStruct, testThread);
+	asyncStructDelegate(structParam, &structParam);
+
+	auto FreeFunc0Delegate = MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE);
+	FreeFunc0Delegate();
+	ASSERT_TRUE(valueCount == 5);
+}
+
+static std::atomic<INT> rcuCount(0);
+static MulticastDelegateRcu<void(INT)>* rcuDelegate = nullptr;
+
+void FreeFuncRcu(INT i) { ASSERT_TRUE(i == TEST_INT); rcuCount++; }
+void FreeFuncRcu2(INT i) { ASSERT_TRUE(i == TEST_INT); rcuCount += 100; }
+void FreeFuncRcuRemoveSelf(INT i) 
+{ 
+	// Modifying the container from within its own callback must not deadlock
+	*rcuDelegate -= MakeDelegate(&FreeFuncRcuRemoveSelf); 
+	*rcuDelegate += MakeDelegate(&FreeFuncRcu2);
+	rcuCount += 10000;
+}
+
+void MulticastDelegateRcuTests()
+{
+	TestClass1 testClass1;
+	MulticastDelegateRcu<void(INT)> delegate;
+	rcuDelegate = &delegate;
+	rcuCount = 0;
+
+	ASSERT_TRUE(delegate.Empty() == true);
+	ASSERT_TRUE(!delegate);
+	delegate(TEST_INT);
+	delegate -= MakeDelegate(&FreeFuncRcu);
+
+	delegate += MakeDelegate(&FreeFuncRcu);
+	delegate += MakeDelegate(&testClass1, &TestClass1::MemberFuncInt1);
+	delegate += MakeDelegate(&FreeFuncRcu);
+	ASSERT_TRUE(delegate.Empty() == false);
+	ASSERT_TRUE(delegate);
+	delegate(TEST_INT);
+	ASSERT_TRUE(rcuCount == 2);
+
+	// Only the first matching delegate is removed
+	delegate -= MakeDelegate(&FreeFuncRcu);
+	delegate(TEST_INT);
+	ASSERT_TRUE(rcuCount == 3);
+	delegate -= MakeDelegate(&testClass1, &TestClass1::MemberFuncInt1);
+	delegate -= MakeDelegate(&FreeFuncRcu);
+	ASSERT_TRUE(!delegate);
+
+	// Changes made by a callback apply from the next invocation
+	rcuCount = 0;
+	delegate += MakeDelegate(&FreeFuncRcuRemoveSelf);
+	delegate(TEST_INT);
+	ASSERT_TRUE(rcuCount == 10000);
+	delegate(TEST_INT);
+	ASSERT_TRUE(rcuCount == 10100);
+	delegate.Clear();
+	ASSERT_TRUE(delegate.Empty() == true);
+
+	// Invoke from several threads while the list is replaced
+	const INT INVOKERS = 4;
+	const INT INVOKES = 500;
+	rcuCount = 0;
+	delegate += MakeDelegate(&FreeFuncRcu);
+	std::atomic<bool> done(false);
+	std::thread writer([&delegate, &done, &testClass1]() {
+		while (!done)
+		{
+			delegate += MakeDelegate(&testClass1, &TestClass1::MemberFuncInt1);
+			delegate -= MakeDelegate(&testClass1, &TestClass1::MemberFuncInt1);
+			std::this_thread::yield();
+		}
+	});
+	std::vector<std::thread> invokers;
+	for (INT t = 0; t < INVOKERS; t++)
+	{
+		invokers.emplace_back([&delegate, INVOKES]() {
+			for (INT i = 0; i < INVOKES; i++)
+				delegate(TEST_INT);
+		});
+	}
+	for (auto& invoker : invokers)
+		invoker.join();
+	done = true;
+	writer.join();
+
+	// FreeFuncRcu is never removed, so every invocation calls it exactly once
+	ASSERT_TRUE(rcuCount == INVOKERS * INVOKES);
+	rcuDelegate = nullptr;
+}
+
+static std::atomic<INT> connectionCount(0);
+static MulticastDelegate<void(INT)>* connectionDelegate = nullptr;
+static DelegateConnection connectionSelf;
+
+void FreeFuncConnection(INT i) { ASSERT_TRUE(i == TEST_INT); connectionCount++; }
+void FreeFuncConnection2(INT i) { ASSERT_TRUE(i == TEST_INT); connectionCount += 100; }
+void FreeFuncConnectionRemoveSelf(INT i) 
+{ 
+	// Disconnecting itself and adding a delegate from within a callback
+	connectionSelf.Disconnect();
+	*connectionDelegate += MakeDelegate(&FreeFuncConnection2);
+	connectionCount += 10000;
+}
+static std::unique_ptr<ScopedConnection> connectionScoped;
+void FreeFuncConnectionScoped(INT i)
+{
+	// Querying and destroying a connection to the invoking container from within a callback
+	ASSERT_TRUE(connectionSelf.Connected());
+	ASSERT_TRUE(connectionScoped && *connectionScoped);
+	connectionScoped = nullptr;
+	ASSERT_TRUE(!connectionSelf.Connected());
+	connectionCount++;
+}
+
+void DelegateConnectionTests()
+{
+	MulticastDelegate<void(INT)> delegate;
+	connectionDelegate = &delegate;
+	connectionCount = 0;
+
+	// Identical delegates are removed individually by their connection
+	DelegateConnection conn1 = delegate += MakeDelegate(&FreeFuncConnection);
+	DelegateConnection conn2 = delegate += MakeDelegate(&FreeFuncConnection);
+	ASSERT_TRUE(conn1.Connected() && conn2.Connected());
+	delegate(TEST_INT);
+	ASSERT_TRUE(connectionCount == 2);
+	conn2.Disconnect();
+	ASSERT_TRUE(!conn2);
+	ASSERT_TRUE(conn1);
+	delegate(TEST_INT);
+	ASSERT_TRUE(connectionCount == 3);
+
+	// A copy refers to the same subscription. Disconnecting twice does nothing.
+	DelegateConnection copy = conn1;
+	copy.Disconnect();
+	ASSERT_TRUE(!conn1);
+	conn1.Disconnect();
+	ASSERT_TRUE(delegate.Empty());
+
+	// ScopedConnection removes its delegate when destroyed
+	{
+		ScopedConnection scoped = delegate += MakeDelegate(&FreeFuncConnection);
+		ASSERT_TRUE(scoped.Connected());
+		ASSERT_TRUE(!delegate.Empty());
+	}
+	ASSERT_TRUE(delegate.Empty());
+	{
+		ScopedConnection scoped = delegate += MakeDelegate(&FreeFuncConnection);
+		ScopedConnection moved = std::move(scoped);
+		ASSERT_TRUE(!scoped.Connected());
+		ASSERT_TRUE(moved.Connected());
+		conn1 = moved.Release();
+	}
+	ASSERT_TRUE(conn1.Connected());
+	conn1.Disconnect();
+
+	// operator-= and Disconnect remove different delegates
+	conn1 = delegate += MakeDelegate(&FreeFuncConnection);
+	conn2 = delegate += MakeDelegate(&FreeFuncConnection2);
+	delegate -= MakeDelegate(&FreeFuncConnection);
+	ASSERT_TRUE(!conn1.Connected());
+	ASSERT_TRUE(conn2.Connected());
+	delegate.Clear();
+	ASSERT_TRUE(!conn2.Connected());
+
+	// Changes made by a callback apply from the next invocation
+	connectionCount = 0;
+	delegate += MakeDelegate(&FreeFuncConnection);
+	connectionSelf = delegate += MakeDelegate(&FreeFuncConnectionRemoveSelf);
+	delegate += MakeDelegate(&FreeFuncConnection);
+	delegate(TEST_INT);
+	ASSERT_TRUE(connectionCount == 10002);
+	ASSERT_TRUE(!connectionSelf.Connected());
+	delegate(TEST_INT);
+	ASSERT_TRUE(connectionCount == 10104);
+	delegate.Clear();
+
+	// Churn compacts the array while keeping the remaining order
+	const INT SUBSCRIBERS = 100;
+	std::vector<DelegateConnection> connections;
+	for (INT i = 0; i < SUBSCRIBERS; i++)
+		connections.push_back(delegate += MakeDelegate(&FreeFuncSlot));
+	for (INT i = 0; i < SUBSCRIBERS; i += 2)
+		connections[i].Disconnect();
+	for (INT i = 1; i < SUBSCRIBERS; i += 2)
+		ASSERT_TRUE(connections[i].Connected());
+	slotOrder.clear();
+	delegate(TEST_INT);
+	ASSERT_TRUE(slotOrder.size() == SUBSCRIBERS / 2);
+	for (INT i = 1; i < SUBSCRIBERS; i += 2)
+		connections[i].Disconnect();
+	ASSERT_TRUE(delegate.Empty());
+
+	// A connection outliving its container does nothing
+	{
+		MulticastDelegate<void(INT)> temp;
+		conn1 = temp += MakeDelegate(&FreeFuncConnection);
+	}
+	ASSERT_TRUE(!conn1.Connected());
+	conn1.Disconnect();
+	connectionDelegate = nullptr;
+
+	// Disconnect from another thread while invoking
+	MulticastDelegateSafe<void(INT)> safe;
+	connectionCount = 0;
+	safe += MakeDelegate(&FreeFuncConnection);
+	std::atomic<bool> done(false);
+	std::thread other([&safe, &done]() {
+		while (!done)
+		{
+			ScopedConnection scoped = safe += MakeDelegate(&FreeFuncConnection2);
+			std::this_thread::yield();
+		}
+	});
+	const INT INVOKES = 50;
+	for (INT i = 0; i < INVOKES; i++)
+		safe(TEST_INT);
+	done = true;
+	other.join();
+	ASSERT_TRUE(connectionCount % 100 == INVOKES);
+	safe.Clear();
+
+	// A callback using a connection to its own thread-safe container, while another
+	// thread holds a connection waiting on the container
+	connectionCount = 0;
+	connectionSelf = safe += MakeDelegate(&FreeFuncConnectionScoped);
+	connectionScoped.reset(new ScopedConnection(connectionSelf));
+	safe(TEST_INT);
+	ASSERT_TRUE(connectionCount == 1);
+	ASSERT_TRUE(safe.Empty());
+	done = false;
+	std::thread scoped([&safe, &done]() {
+		while (!done)
+		{
+			ScopedConnection scoped = safe += MakeDelegate(&FreeFuncConnection2);
+			std::this_thread::yield();
+		}
+	});
+	for (INT i = 0; i < INVOKES; i++)
+	{
+		connectionSelf = safe += MakeDelegate(&FreeFuncConnectionScoped);
+		connectionScoped.reset(new ScopedConnection(connectionSelf));
+		safe(TEST_INT);
+	}
+	done = true;
+	scoped.join();
+	ASSERT_TRUE(connectionCount % 100 == INVOKES + 1);
+	ASSERT_TRUE(safe.Empty());
+	connectionSelf = DelegateConnection();
+}
+
+static std::atomic<INT> broadcastCount(0);
+static std::atomic<const CopyCounter*> broadcastArg(nullptr);
+static std::vector<INT> broadcastOrder;
+
+void FreeFuncBroadcast(const CopyCounter& c) 
+{ 
+	// Every asynchronous subscriber reads the same copy
+	ASSERT_TRUE(c.val == TEST_INT); 
+	const CopyCounter* expected = nullptr;
+	if (!broadcastArg.compare_exchange_strong(expected, &c))
+		ASSERT_TRUE(expected == &c);
+	broadcastCount++; 
+}
+void FreeFuncBroadcastSync(const CopyCounter& c) { ASSERT_TRUE(c.val == TEST_INT); broadcastCount += 1000; }
+void FreeFuncBroadcastValue(INT i, const StructParam* s) { ASSERT_TRUE(i == TEST_INT && s->val == TEST_INT); broadcastCount++; }
+
+class TestClassBroadcast
+{
+public:
+	TestClassBroadcast(INT id) : m_id(id) {}
+	void MemberFuncBroadcast(const CopyCounter& c) { ASSERT_TRUE(c.val == TEST_INT); broadcastOrder.push_back(m_id); }
+private:
+	INT m_id;
+};
+
+void BroadcastTests()
+{
+#if USE_STD_THREADS
+	DelegateThread& otherThread = testThreadMpsc;
+#else
+	DelegateThread& otherThread = testThread;
+#endif
+	MulticastDelegateSafe<void(const CopyCounter&)> delegate;
+	broadcastCount = 0;
+	broadcastArg = nullptr;
+
+	// Asynchronous subscribers on two threads, and a synchronous subscriber
+	delegate += MakeDelegate(&FreeFuncBroadcast, testThread);
+	delegate += MakeDelegate(&FreeFuncBroadcastSync);
+	delegate += MakeDelegate(&FreeFuncBroadcast, otherThread);
+	delegate += MakeDelegate(&FreeFuncBroadcast, testThread);
+	DelegateConnection conn = delegate += MakeDelegate(&FreeFuncBroadcast, otherThread);
+
+	// The argument is copied once for all asynchronous subscribers
+	CopyCounter counter;
+	CopyCounter::copies = 0;
+	delegate.Broadcast(counter);
+	ASSERT_TRUE(CopyCounter::copies == 1);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	MakeDelegate(&FreeFunc0, otherThread, WAIT_INFINITE)();
+	ASSERT_TRUE(broadcastCount == 1004);
+
+	// A removed subscriber is excluded from the next broadcast
+	conn.Disconnect();
+	broadcastArg = nullptr;
+	delegate.Broadcast(counter);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	MakeDelegate(&FreeFunc0, otherThread, WAIT_INFINITE)();
+	ASSERT_TRUE(broadcastCount == 2007);
+	delegate.Clear();
+
+	// Subscribers of one thread are invoked in the order added
+	std::vector<std::unique_ptr<TestClassBroadcast>> objects;
+	MulticastDelegate<void(const CopyCounter&)> ordered;
+	for (INT i = 0; i < 10; i++)
+	{
+		objects.emplace_back(new TestClassBroadcast(i));
+		ordered += MakeDelegate(objects.back().get(), &TestClassBroadcast::MemberFuncBroadcast, testThread);
+	}
+	broadcastOrder.clear();
+	ordered.Broadcast(counter);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	ASSERT_TRUE(broadcastOrder.size() == 10);
+	for (INT i = 0; i < 10; i++)
+		ASSERT_TRUE(broadcastOrder[i] == i);
+
+	// Pass by value and pointer to const arguments
+	MulticastDelegate<void(INT, const StructParam*)> values;
+	values += MakeDelegate(&FreeFuncBroadcastValue, testThread);
+	values += MakeDelegate(&FreeFuncBroadcastValue, otherThread);
+	values += MakeDelegate(&FreeFuncBroadcastValue);
+	StructParam param;
+	param.val = TEST_INT;
+	broadcastCount = 0;
+	values.Broadcast(TEST_INT, &param);
+	MakeDelegate(&FreeFunc0, testThread, WAIT_INFINITE)();
+	MakeDelegate(&FreeFunc0, otherThread, WAIT_INFINITE)();
+	ASSERT_TRUE(broadcastCount == 3);
+
+#if USE_STD_THREADS
+	// Each thread receives one message per subscriber priority
+	WorkerThread thread("DelegateUnitTestsBroadcastThread");
+	thread.CreateThread();
+	auto high = MakeDelegate(&FreeFuncPriority, thread);
+	high.SetPriority(DelegatePriority::HIGH);
+	MulticastDelegate<void(INT)> prioritized;
+	prioritized += MakeDelegate(&FreeFuncPriority, thread);
+	prioritized += high;
+	priorityOrder.clear();
+	PriorityGate(thread);
+	prioritized.Broadcast(1);
+	prioritized.Broadcast(2);
+	PriorityRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 1, 2, 1, 2 }));
+
+	// A subscriber with a coalesce key dispatches its own message, which a full 
+	// coalescing queue can replace
+	thread.ExitThread();
+	thread.SetQueueCapacity(2, WorkerThread::OverflowPolicy::COALESCE);
+	thread.CreateThread();
+	auto keyed = MakeDelegate(&FreeFuncPriority, thread);
+	keyed.SetCoalesceKey(&keyed);
+	MulticastDelegate<void(INT)> coalesced;
+	coalesced += keyed;
+	priorityOrder.clear();
+	PriorityGate(thread);
+	coalesced.Broadcast(1);
+	coalesced.Broadcast(2);
+	BoundedRelease(thread);
+	ASSERT_TRUE(priorityOrder == std::vector<INT>({ 2 }));
+	thread.ExitThread();
+#endif
+}
+
 void DelegateUnitTests()
 {
 	testThread.CreateThread();
+#if USE_STD_THREADS
+	testThreadMpsc.CreateThread();
+#endif
 
 #ifdef WIN32
 	LARGE_INTEGER StartingTime, EndingTime, ElapsedMicroseconds, TotalElapsedMicroseconds = { 0 };
@@ -2563,10 +4598,39 @@ void DelegateUnitTests()
 		SinglecastDelegateTests();
 		MulticastDelegateTests();
 		MulticastDelegateSafeTests();
+		MulticastDelegateRcuTests();
+		MulticastDelegateSlotTests();
+		DelegateValueTests();
+		DelegateConnectionTests();
+		BroadcastTests();
 		MulticastDelegateSafeAsyncTests();
 		DelegateMemberAsyncWaitTests();
 		DelegateMemberSpTests();
 		DelegateMemberAsyncSpTests();
+		InlineDispatchTests();
+		SharedTargetTests();
+		VariadicArgsTests();
+		MoveOnlyArgsTests();
+		InvokeBatchTests(testThread);
+#if USE_STD_THREADS
+		InvokeBatchTests(testThreadMpsc);
+		SpinCountTests();
+		WorkerThreadMpscTests();
+		WorkerThreadPoolTests();
+		WorkerStrandTests();
+		PriorityTests();
+		BoundedQueueTests();
+		ConflateTests();
+		FutureTests();
+		WhenAllAnyTests();
+		AsyncRequestTests();
+		SemaphoreTests();
+#if defined(__cpp_impl_coroutine)
+		CoroutineTests();
+#endif
+#endif
+		TimerTests();
+		ManualTimerTests();
 	}
 
 #ifdef WIN32
@@ -2578,6 +4642,9 @@ void DelegateUnitTests()
 #endif
 
 	testThread.ExitThread();
+#if USE_STD_THREADS
+	testThreadMpsc.ExitThread();
+#endif
 }
 
 #endif // DELEGATE_UNIT_TESTS
\ No newline at end of file
@@ -0,0 +1,211 @@
+#ifndef _DELEGATE_VALUE_H
+#define _DELEGATE_VALUE_H
+
+// DelegateValue.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// A non-polymorphic delegate with value semantics. The bound target is held within
+// fixed inline storage, so constructing, copying and storing a DelegateValue<> never
+// allocates. The type is trivially copyable: containers may relocate it with memcpy.
+// Equality compares the stored bytes, without RTTI or a virtual call.
+
+#include "IDelegateThread.h"
+#include "DelegateMsgInline.h"
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace DelegateLib {
+
+/// An incomplete class. A pointer to member function of an incomplete class uses the
+/// largest representation a compiler supports for any class.
+class DelegateValueUnknownClass;
+
+/// Size in bytes of the DelegateValue<> storage: an object pointer plus a pointer to
+/// member function.
+const size_t DELEGATE_VALUE_STORAGE_SIZE = sizeof(void*) + sizeof(void (DelegateValueUnknownClass::*)());
+
+template <class R>
+class DelegateValue; // Not defined
+
+/// @brief A trivially copyable delegate bound to a free function, or to a member function
+/// and object pointer. Synchronous unless constructed with a DelegateThread, in which
+/// case each invocation is dispatched to that thread using DelegateMsgInline.
+/// @details Does not participate in the Delegate<> class hierarchy and cannot be added
+/// to the delegate containers. Store it by value instead, e.g. within a std::vector.
+template <class RetType, class... Args>
+class DelegateValue<RetType(Args...)>
+{
+public:
+    typedef RetType(*FreeFunc)(Args...);
+
+    /// Construct an empty delegate.
+    DelegateValue() { Clear(); }
+
+    /// Bind a free function.
+    DelegateValue(FreeFunc func) { Bind(func); }
+
+    /// Bind a free function invoked asynchronously on thread.
+    DelegateValue(FreeFunc func, DelegateThread& thread) { Bind(func, thread); }
+
+    /// Bind a member function.
+    template <class TClass>
+    DelegateValue(TClass* object, RetType(TClass::*func)(Args...)) { Bind(object, func); }
+
+    /// Bind a const member function.
+    template <class TClass>
+    DelegateValue(const TClass* object, RetType(TClass::*func)(Args...) const) { Bind(object, func); }
+
+    /// Bind a member function invoked asynchronously on thread.
+    template <class TClass>
+    DelegateValue(TClass* object, RetType(TClass::*func)(Args...), DelegateThread& thread) { Bind(object, func, thread); }
+
+    /// Bind a const member function invoked asynchronously on thread.
+    template <class TClass>
+    DelegateValue(const TClass* object, RetType(TClass::*func)(Args...) const, DelegateThread& thread) { Bind(object, func, thread); }
+
+    /// Bind a free function.
+    void Bind(FreeFunc func) {
+        static_assert(sizeof(FreeFunc) <= DELEGATE_VALUE_STORAGE_SIZE - sizeof(void*), "Function pointer too large");
+        Clear();
+        if (func)
+        {
+            Store(func, nullptr);
+            m_stub = &FreeStub;
+        }
+    }
+
+    /// Bind a free function invoked asynchronously on thread.
+    void Bind(FreeFunc func, DelegateThread& thread) {
+        Bind(func);
+        SetThread(thread);
+    }
+
+    /// Bind a member function.
+    template <class TClass>
+    void Bind(TClass* object, RetType(TClass::*func)(Args...)) { BindMember(object, func); }
+
+    /// Bind a const member function.
+    template <class TClass>
+    void Bind(const TClass* object, RetType(TClass::*func)(Args...) const) { BindMember(object, func); }
+
+    /// Bind a member function invoked asynchronously on thread.
+    template <class TClass>
+    void Bind(TClass* object, RetType(TClass::*func)(Args...), DelegateThread& thread) {
+        BindMember(object, func);
+        SetThread(thread);
+    }
+
+    /// Bind a const member function invoked asynchronously on thread.
+    template <class TClass>
+    void Bind(const TClass* object, RetType(TClass::*func)(Args...) const, DelegateThread& thread) {
+        BindMember(object, func);
+        SetThread(thread);
+    }
+
+    /// Invoke the bound function. An asynchronous delegate dispatches the call to its
+    /// thread and returns immediately.
+    /// @pre The delegate is not empty.
+    RetType operator()(Args... args) const {
+        if constexpr (std::is_void<RetType>::value)
+        {
+            if (m_thread)
+            {
+                DelegateValue target = *this;
+                target.m_thread = nullptr;
+                m_thread->DispatchDelegateInline(DelegateMsgInline(DelegateInlineCall<DelegateValue, Args...>(target, std::forward<Args>(args)...)));
+                return;
+            }
+        }
+        return m_stub(m_storage, std::forward<Args>(args)...);
+    }
+
+    /// @return The thread an asynchronous delegate dispatches to, or nullptr if synchronous.
+    DelegateThread* GetThread() const { return m_thread; }
+
+    bool Empty() const { return m_stub == nullptr; }
+
+    void Clear() {
+        m_stub = nullptr;
+        m_thread = nullptr;
+        std::memset(m_storage, 0, sizeof(m_storage));
+    }
+
+    explicit operator bool() const { return !Empty(); }
+
+    /// Two delegates are equal if bound to the same function, object and thread.
+    bool operator==(const DelegateValue& rhs) const {
+        return m_stub == rhs.m_stub &&
+            m_thread == rhs.m_thread &&
+            std::memcmp(m_storage, rhs.m_storage, sizeof(m_storage)) == 0;
+    }
+    bool operator!=(const DelegateValue& rhs) const { return !(*this == rhs); }
+
+private:
+    typedef RetType(*Stub)(const unsigned char* storage, Args... args);
+
+    template <class TObject, class TFunc>
+    void BindMember(TObject* object, TFunc func) {
+        static_assert(sizeof(TFunc) <= DELEGATE_VALUE_STORAGE_SIZE - sizeof(void*), "Member function pointer too large");
+        Clear();
+        if (object && func)
+        {
+            Store(func, object);
+            m_stub = &MemberStub<TObject, TFunc>;
+        }
+    }
+
+    void SetThread(DelegateThread& thread) {
+        static_assert(std::is_void<RetType>::value, "Asynchronous delegate must return void");
+        m_thread = &thread;
+    }
+
+    /// Copy the object pointer and function pointer into the storage
+    template <class TFunc>
+    void Store(TFunc func, const void* object) {
+        std::memcpy(m_storage, &object, sizeof(object));
+        std::memcpy(m_storage + sizeof(void*), &func, sizeof(func));
+    }
+
+    static RetType FreeStub(const unsigned char* storage, Args... args) {
+        FreeFunc func;
+        std::memcpy(&func, storage + sizeof(void*), sizeof(func));
+        return std::invoke(func, std::forward<Args>(args)...);
+    }
+
+    template <class TObject, class TFunc>
+    static RetType MemberStub(const unsigned char* storage, Args... args) {
+        const void* object;
+        TFunc func;
+        std::memcpy(&object, storage, sizeof(object));
+        std::memcpy(&func, storage + sizeof(void*), sizeof(func));
+        return std::invoke(func, static_cast<TObject*>(const_cast<void*>(object)), std::forward<Args>(args)...);
+    }
+
+    Stub m_stub;
+    DelegateThread* m_thread;
+    alignas(void*) unsigned char m_storage[DELEGATE_VALUE_STORAGE_SIZE];
+};
+
+template <class RetType, class... Args>
+DelegateValue(RetType(*)(Args...)) -> DelegateValue<RetType(Args...)>;
+
+template <class RetType, class... Args>
+DelegateValue(RetType(*)(Args...), DelegateThread&) -> DelegateValue<RetType(Args...)>;
+
+template <class TClass, class RetType, class... Args>
+DelegateValue(TClass*, RetType(TClass::*)(Args...)) -> DelegateValue<RetType(Args...)>;
+
+template <class TClass, class RetType, class... Args>
+DelegateValue(const TClass*, RetType(TClass::*)(Args...) const) -> DelegateValue<RetType(Args...)>;
+
+template <class TClass, class RetType, class... Args>
+DelegateValue(TClass*, RetType(TClass::*)(Args...), DelegateThread&) -> DelegateValue<RetType(Args...)>;
+
+template <class TClass, class RetType, class... Args>
+DelegateValue(const TClass*, RetType(TClass::*)(Args...) const, DelegateThread&) -> DelegateValue<RetType(Args...)>;
+
+}
+
+#endif
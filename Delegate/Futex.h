@@ -0,0 +1,84 @@
+#ifndef _FUTEX_H
+#define _FUTEX_H
+
+// Futex.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Thin wrapper over the operating system "wait on address" primitive. A thread
+// parks on a 32-bit atomic word until another thread changes the word and wakes it.
+// Linux uses futex(2) and Windows uses WaitOnAddress(). Other platforms fall back
+// to a short sleep and re-check.
+
+#include "DelegateOpt.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#if defined(__linux__)
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <unistd.h>
+	#include <ctime>
+#elif defined(_WIN32)
+	#include <windows.h>
+	#pragma comment(lib, "Synchronization.lib")
+#else
+	#include <thread>
+#endif
+
+namespace DelegateLib {
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "Futex word must be 32-bits");
+
+#undef max
+
+/// Block the calling thread while word equals expected. The call may return
+/// spuriously; callers must re-check their condition in a loop.
+/// @param[in] word - the atomic word to wait on.
+/// @param[in] expected - the value the word must hold for the thread to park.
+/// @param[in] timeout - maximum time to park.
+inline void FutexWait(std::atomic<uint32_t>& word, uint32_t expected,
+	std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max())
+{
+#if defined(__linux__)
+	struct timespec ts;
+	struct timespec* pts = nullptr;
+	if (timeout != std::chrono::nanoseconds::max())
+	{
+		auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+		ts.tv_sec = static_cast<time_t>(secs.count());
+		ts.tv_nsec = static_cast<long>((timeout - secs).count());
+		pts = &ts;
+	}
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, pts, nullptr, 0);
+#elif defined(_WIN32)
+	DWORD ms = INFINITE;
+	if (timeout != std::chrono::nanoseconds::max())
+		ms = static_cast<DWORD>(std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count());
+	WaitOnAddress(reinterpret_cast<volatile VOID*>(&word), &expected, sizeof(uint32_t), ms);
+#else
+	if (word.load(std::memory_order_acquire) == expected)
+		std::this_thread::sleep_for(std::min(timeout, std::chrono::nanoseconds(50000)));
+#endif
+}
+
+/// Wake threads parked on word by FutexWait().
+/// @param[in] word - the atomic word threads are waiting on.
+/// @param[in] all - true to wake all waiters, false to wake at most one.
+inline void FutexWake(std::atomic<uint32_t>& word, bool all = false)
+{
+#if defined(__linux__)
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, all ? INT32_MAX : 1, nullptr, nullptr, 0);
+#elif defined(_WIN32)
+	if (all)
+		WakeByAddressAll(reinterpret_cast<PVOID>(&word));
+	else
+		WakeByAddressSingle(reinterpret_cast<PVOID>(&word));
+#else
+	(void)word;
+	(void)all;
+#endif
+}
+
+}
+
+#endif
@@ -2,6 +2,8 @@
 #define _DELEGATE_THREAD_H
 
 #include "DelegateMsg.h"
+#include "DelegateMsgInline.h"
+#include <vector>
 
 namespace DelegateLib {
 
@@ -16,12 +18,96 @@ public:
 	/// Dispatch a DelegateMsg onto this thread. The implementer is responsible
 	/// for getting the DelegateMsg into an OS message queue. Once DelegateMsg
 	/// is on the correct thread of control, the DelegateInvoker::DelegateInvoke() function
-	/// must be called to execute the callback. 
+	/// must be called to execute the callback.
 	/// @param[in] msg - a pointer to the callback message that must be created dynamically
-	///		using operator new. 
+	///		using operator new.
 	/// @pre Caller *must* create the DelegateMsg argument dynamically using operator new.
 	/// @post The destination thread must delete the msg instance by calling DelegateInvoke().
-	virtual void DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg) = 0;
+	/// @return True if the message was queued, false if a bounded queue rejected it.
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg) = 0;
+
+	/// Dispatch an inline delegate message onto this thread. Once on the correct thread
+	/// of control, DelegateMsgInline::Invoke() must be called to execute the callback.
+	/// Implementations that store messages by value in their queue should override this
+	/// function to avoid any heap allocation. The default implementation wraps the
+	/// message within a heap DelegateMsgBase, keeping its priority, coalesce key and
+	/// discardable flag, and calls DispatchDelegate().
+	/// @param[in] msg - the callback message. Moved into the thread queue.
+	/// @return True if the message was queued, false if a bounded queue rejected it.
+	virtual bool DispatchDelegateInline(DelegateMsgInline&& msg)
+	{
+		const DelegatePriority priority = msg.GetPriority();
+		const void* coalesceKey = msg.GetCoalesceKey();
+		const bool discardable = msg.IsDiscardable();
+
+		auto invoker = std::make_shared<DelegateMsgInlineInvoker>(std::move(msg));
+		auto wrapper = std::make_shared<DelegateMsgBase>(invoker);
+		wrapper->SetPriority(priority);
+		wrapper->SetCoalesceKey(coalesceKey);
+		wrapper->SetDiscardable(discardable);
+		return DispatchDelegate(wrapper);
+	}
+
+	/// Dispatch a batch of delegate messages onto this thread, in order. Implementations
+	/// should override this function to enqueue the whole batch with one queue operation
+	/// and one wake-up. The default implementation calls DispatchDelegate() for each message.
+	/// @param[in] msgs - the callback messages.
+	/// @return The number of messages queued.
+	virtual size_t DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateMsgBase>>& msgs)
+	{
+		size_t accepted = 0;
+		for (auto& msg : msgs)
+			accepted += DispatchDelegate(msg) ? 1 : 0;
+		return accepted;
+	}
+
+	/// Dispatch a batch of inline delegate messages onto this thread, in order. The default
+	/// implementation calls DispatchDelegateInline() for each message.
+	/// @param[in] msgs - the callback messages. Moved into the thread queue.
+	/// @return The number of messages queued.
+	virtual size_t DispatchDelegateInlineBatch(std::vector<DelegateMsgInline>&& msgs)
+	{
+		size_t accepted = 0;
+		for (auto& msg : msgs)
+			accepted += DispatchDelegateInline(std::move(msg)) ? 1 : 0;
+		return accepted;
+	}
+
+private:
+	/// Adapts a DelegateMsgInline to the IDelegateInvoker interface
+	class DelegateMsgInlineInvoker : public IDelegateInvoker
+	{
+	public:
+		DelegateMsgInlineInvoker(DelegateMsgInline&& msg) : m_msg(std::move(msg)) {}
+		virtual void DelegateInvoke(std::shared_ptr<DelegateMsgBase>) override { m_msg.Invoke(); }
+	private:
+		DelegateMsgInline m_msg;
+	};
+};
+
+/// @brief Records the DelegateThread whose messages the calling thread is invoking, for 
+/// code that must later return to the same thread, e.g. a resumed coroutine. Each 
+/// DelegateThread implementation creates a scope around its message loop.
+class DelegateThreadScope
+{
+public:
+	explicit DelegateThreadScope(DelegateThread* thread) : m_prev(Current()) { Current() = thread; }
+	~DelegateThreadScope() { Current() = m_prev; }
+
+	/// @return The DelegateThread invoking messages on the calling thread, or nullptr if
+	///     the calling thread is not a DelegateThread.
+	static DelegateThread* GetCurrent() { return Current(); }
+
+private:
+	DelegateThreadScope(const DelegateThreadScope&) = delete;
+	DelegateThreadScope& operator=(const DelegateThreadScope&) = delete;
+
+	static DelegateThread*& Current() {
+		thread_local DelegateThread* current = nullptr;
+		return current;
+	}
+
+	DelegateThread* const m_prev;
 };
 
 }
@@ -2,69 +2,376 @@
 #define _MULTICAST_DELEGATE_H
 
 #include "Delegate.h"
-#include <list>
+#include "DelegateConnection.h"
+#include "DelegateBroadcast.h"
+#include "DelegateMsgInline.h"
+#include <vector>
 #include <algorithm>
+#include <memory>
 
 namespace DelegateLib {
 
 template <class R>
 struct MulticastDelegate; // Not defined
 
-/// @brief Not thread-safe multicast delegate container class. The class has a linked  
-/// list of Delegate<> instances. When invoked, each Delegate instance within the invocation 
-/// list is called. MulticastDelegate<> does not support return values. A void return  
-/// must always be used.
+/// @brief Not thread-safe multicast delegate container class. The class has a contiguous
+/// array of Delegate<> instances. Each delegate is stored inline within its array slot
+/// when it fits within DELEGATE_SLOT_SIZE bytes, so invoking the container is a linear
+/// scan without a heap pointer to chase per delegate. Larger delegates are held on the
+/// heap. When invoked, each Delegate instance within the invocation list is called.
+/// MulticastDelegate<> does not support return values. A void return must always be used.
+/// @details operator+= returns a DelegateConnection that removes the delegate without
+/// comparing it against the others. A removed slot is marked empty and the array is
+/// compacted once half the slots are empty, so removal is amortized O(log n). A callback
+/// may add or remove delegates, including itself; added delegates are first invoked on
+/// the next invocation.
+/// 
+/// Broadcast() is an alternative to operator() for asynchronous subscribers. The
+/// arguments are copied once into a payload shared by all target threads, and each
+/// thread receives a single message per broadcast and subscriber priority.
 template<class RetType, class... Args>
-class MulticastDelegate<RetType(Args...)>
+class MulticastDelegate<RetType(Args...)> : protected IDelegateConnectionList
 {
 public:
     MulticastDelegate() = default;
-    ~MulticastDelegate() { Clear(); }
+    ~MulticastDelegate() {
+        DetachConnections();
+        Clear();
+    }
 
     RetType operator()(Args... args) {
-        for (Delegate<RetType(Args...)>* delegate : m_delegates)
-            (*delegate)(args...);	// Invoke delegate callback
+        InvokeGuard guard(*this);
+
+        // Index based, as a callback may append to m_delegates
+        const size_t size = m_delegates.size();
+        for (size_t i = 0; i < size; i++)
+        {
+            Delegate<RetType(Args...)>* delegate = m_delegates[i].Get();
+            if (delegate)
+                (*delegate)(args...);	// Invoke delegate callback
+        }
     }
 
-    void operator+=(const Delegate<RetType(Args...)>& delegate) {
-        m_delegates.push_back(delegate.Clone());
+    /// Invoke all delegates, sharing one copy of the arguments between the asynchronous
+    /// delegates. Each target thread receives one message per subscriber priority, 
+    /// invoking those subscribers in the order added. The messages are dispatched first,
+    /// then any synchronous, blocking, conflating and coalescing delegates are invoked on 
+    /// the calling thread. Every argument must be passed by value, by const reference or
+    /// by pointer to const, as the target threads share the copy.
+    void Broadcast(Args... args) {
+        static_assert((is_broadcast_arg<Args>::value && ...),
+            "Broadcast argument must be a copyable value, const reference or pointer to const");
+        InvokeGuard guard(*this);
+
+        // Hold the plan, as a synchronous callback may modify the container
+        std::shared_ptr<const BroadcastPlan> plan = m_plan;
+        if (!plan)
+            plan = m_plan = CreatePlan();
+
+        if (!plan->groups.empty())
+        {
+            auto payload = std::make_shared<const typename BroadcastCall::Payload>(BroadcastArg<Args>(args)...);
+            for (auto& group : plan->groups)
+            {
+                DelegateMsgInline msg(BroadcastCall(group.targets, payload));
+                msg.SetPriority(DelegatePriorityScope::Resolve(group.priority));
+                group.thread->DispatchDelegateInline(std::move(msg));
+            }
+        }
+        for (size_t index : plan->syncSlots)
+        {
+            Delegate<RetType(Args...)>* delegate = m_delegates[index].Get();
+            if (delegate)
+                (*delegate)(args...);	// Invoke delegate callback
+        }
+    }
+
+    /// Add a delegate.
+    /// @return A connection that removes the delegate.
+    DelegateConnection operator+=(const Delegate<RetType(Args...)>& delegate) {
+        if (!m_anchor)
+            m_anchor = std::make_shared<DelegateConnectionAnchor>(static_cast<IDelegateConnectionList*>(this));
+
+        // Delegates added by a callback are held aside until the invocation completes
+        const uint64_t id = ++m_lastId;
+        m_plan = nullptr;
+        if (m_invoking)
+            m_added.emplace_back(delegate, id);
+        else
+            m_delegates.emplace_back(delegate, id);
+        m_size++;
+        return DelegateConnection(m_anchor, id);
     }
     void operator-=(const Delegate<RetType(Args...)>& delegate) {
-        for (auto it = m_delegates.begin(); it != m_delegates.end(); ++it)
+        for (auto list : { &m_delegates, &m_added })
         {
-            if (*((DelegateBase*)&delegate) == *((DelegateBase*)(*it)))
+            for (auto& slot : *list)
             {
-                delete (*it);
-                m_delegates.erase(it);
-                break;
+                if (slot.Get() && *((DelegateBase*)&delegate) == *((DelegateBase*)slot.Get()))
+                {
+                    Remove(slot, list == &m_added);
+                    return;
+                }
             }
         }
     }
 
     /// Any registered delegates?
-    bool Empty() const { return m_delegates.empty(); }
+    bool Empty() const { return m_size == 0; }
 
     /// Removal all registered delegates.
     void Clear() {
-        auto it = m_delegates.begin();
-        while (it != m_delegates.end())
+        m_plan = nullptr;
+        if (m_invoking)
         {
-            delete (*it);
-            it = m_delegates.erase(it);
+            for (auto& slot : m_delegates)
+                slot.Disconnect();
+            m_added.clear();
+            m_removed = m_delegates.size();
         }
+        else
+        {
+            m_delegates.clear();
+            m_removed = 0;
+        }
+        m_size = 0;
     }
 
     explicit operator bool() const { return !Empty(); }
 
+protected:
+    /// Remove the delegate added with id, if still present.
+    virtual void Disconnect(uint64_t id) override {
+        Slot* slot = Find(m_delegates, id);
+        if (slot)
+            Remove(*slot, false);
+        else if ((slot = Find(m_added, id)) != nullptr)
+            Remove(*slot, true);
+    }
+
+    /// @return True if the delegate added with id is still present.
+    virtual bool IsConnected(uint64_t id) override {
+        return Find(m_delegates, id) || Find(m_added, id);
+    }
+
+    /// Detach outstanding connections from this container. Called by the destructor
+    /// of the most derived class before the container is destroyed.
+    void DetachConnections() {
+        if (m_anchor)
+            m_anchor->Detach();
+        m_anchor = nullptr;
+    }
+
 private:
     // Prevent copying objects
     MulticastDelegate(const MulticastDelegate&) = delete;
     MulticastDelegate& operator=(const MulticastDelegate&) = delete;
 
-    /// List of registered delegates
-    std::list<Delegate<RetType(Args...)>*> m_delegates;
+    /// One element of the invocation list. Holds a copy of a delegate within its own
+    /// storage using Delegate<>::CloneTo(), or on the heap if the delegate is too large.
+    class Slot
+    {
+    public:
+        typedef Delegate<RetType(Args...)> DelegateType;
+
+        Slot(const DelegateType& delegate, uint64_t id) : m_id(id), m_connected(true) {
+            m_delegate = delegate.CloneTo(m_storage, sizeof(m_storage));
+            m_inline = m_delegate != nullptr;
+            if (!m_inline)
+                m_delegate = delegate.Clone();
+        }
+        Slot(Slot&& rhs) noexcept { MoveFrom(rhs); }
+        Slot& operator=(Slot&& rhs) noexcept {
+            if (&rhs != this)
+            {
+                Reset();
+                MoveFrom(rhs);
+            }
+            return *this;
+        }
+        ~Slot() { Reset(); }
+
+        /// @return The delegate, or nullptr if the slot was removed.
+        DelegateType* Get() const { return m_connected ? m_delegate : nullptr; }
+
+        uint64_t GetId() const { return m_id; }
+
+        /// Remove the delegate without destroying it. A delegate removed by its own
+        /// callback is still executing, so is destroyed later by Reset().
+        void Disconnect() { m_connected = false; }
+
+        /// Destroy the delegate, leaving an empty slot.
+        void Reset() {
+            if (m_inline)
+                m_delegate->~DelegateType();
+            else
+                delete m_delegate;
+            m_delegate = nullptr;
+            m_inline = false;
+            m_connected = false;
+        }
+
+    private:
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        void MoveFrom(Slot& rhs) noexcept {
+            m_id = rhs.m_id;
+            m_connected = rhs.m_connected;
+            m_inline = rhs.m_inline;
+            if (m_inline)
+            {
+                // A polymorphic delegate cannot be relocated bitwise; copy then destroy
+                m_delegate = rhs.m_delegate->CloneTo(m_storage, sizeof(m_storage));
+                rhs.Reset();
+            }
+            else
+            {
+                m_delegate = rhs.m_delegate;
+                rhs.m_delegate = nullptr;
+            }
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[DELEGATE_SLOT_SIZE];
+        DelegateType* m_delegate = nullptr;
+        uint64_t m_id = 0;
+        bool m_connected = false;
+        bool m_inline = false;
+    };
+
+    /// Tracks nested invocations. When the outermost invocation completes, delegates
+    /// added by callbacks are appended and empty slots are compacted.
+    class InvokeGuard
+    {
+    public:
+        explicit InvokeGuard(MulticastDelegate& multicast) : m_multicast(multicast) { m_multicast.m_invoking++; }
+        ~InvokeGuard() {
+            if (--m_multicast.m_invoking == 0)
+                m_multicast.Update();
+        }
+    private:
+        MulticastDelegate& m_multicast;
+    };
+
+    /// @return The live slot within list added with id, or nullptr. Slot ids increase
+    /// along each array, so a binary search is used.
+    static Slot* Find(std::vector<Slot>& list, uint64_t id) {
+        auto it = std::lower_bound(list.begin(), list.end(), id,
+            [](const Slot& slot, uint64_t id) { return slot.GetId() < id; });
+        if (it != list.end() && it->GetId() == id && it->Get())
+            return &*it;
+        return nullptr;
+    }
+
+    /// Empty a live slot, and compact the array if no invocation is in progress
+    /// @param[in] slot - the slot to remove.
+    /// @param[in] added - true if the slot is within m_added.
+    void Remove(Slot& slot, bool added) {
+        m_size--;
+        m_plan = nullptr;
+        if (m_invoking)
+        {
+            slot.Disconnect();
+            if (!added)
+                m_removed++;
+            return;
+        }
+        slot.Reset();
+        m_removed++;
+        Update();
+    }
+
+    /// Append delegates added during an invocation and compact the array once at
+    /// least half the slots are empty
+    void Update() {
+        if (m_removed > 0 && m_removed * 2 >= m_delegates.size())
+        {
+            m_delegates.erase(std::remove_if(m_delegates.begin(), m_delegates.end(),
+                [](const Slot& slot) { return slot.Get() == nullptr; }), m_delegates.end());
+            m_removed = 0;
+            m_plan = nullptr;
+        }
+        if (!m_added.empty())
+        {
+            m_plan = nullptr;
+            for (auto& slot : m_added)
+            {
+                if (slot.Get())
+                    m_delegates.push_back(std::move(slot));
+            }
+            m_added.clear();
+        }
+    }
+
+    typedef DelegateBroadcastCall<Args...> BroadcastCall;
+
+    /// The subscribers of one target thread and priority
+    struct BroadcastGroup
+    {
+        DelegateThread* thread;
+        DelegatePriority priority;
+        std::shared_ptr<const typename BroadcastCall::TargetList> targets;
+    };
+
+    /// Broadcast() subscribers grouped by target thread and priority. Rebuilt after the
+    /// container is modified.
+    struct BroadcastPlan
+    {
+        std::vector<BroadcastGroup> groups;
+        std::vector<size_t> syncSlots;     // Indices of m_delegates invoked by the caller
+    };
+
+    /// Group the asynchronous delegates by target thread and priority. A delegate with a
+    /// coalesce key is dispatched by itself, so a bounded queue can match the key.
+    std::shared_ptr<const BroadcastPlan> CreatePlan() const {
+        auto plan = std::make_shared<BroadcastPlan>();
+        std::vector<std::shared_ptr<typename BroadcastCall::TargetList>> targets;
+        for (size_t i = 0; i < m_delegates.size(); i++)
+        {
+            auto delegate = m_delegates[i].Get();
+            if (!delegate)
+                continue;
+            auto async = dynamic_cast<const IDelegateAsync<RetType(Args...)>*>(delegate);
+            auto target = async && !async->GetCoalesceKey() ? async->GetSyncDelegate() : nullptr;
+            if (!target)
+            {
+                plan->syncSlots.push_back(i);
+                continue;
+            }
+            DelegateThread* thread = &async->GetThread();
+            const DelegatePriority priority = async->GetPriority();
+            size_t group = 0;
+            while (group < plan->groups.size() && 
+                (plan->groups[group].thread != thread || plan->groups[group].priority != priority))
+                group++;
+            if (group == plan->groups.size())
+            {
+                targets.push_back(std::make_shared<typename BroadcastCall::TargetList>());
+                plan->groups.push_back({ thread, priority, targets.back() });
+            }
+            targets[group]->push_back(target);
+        }
+        return plan;
+    }
+
+    /// Array of registered delegates in the order added
+    std::vector<Slot> m_delegates;
+
+    /// Delegates added during an invocation
+    std::vector<Slot> m_added;
+
+    /// Cached Broadcast() plan, or nullptr if not yet created
+    std::shared_ptr<const BroadcastPlan> m_plan;
+
+    /// Shared with each DelegateConnection. Created on the first operator+=.
+    std::shared_ptr<DelegateConnectionAnchor> m_anchor;
+
+    uint64_t m_lastId = 0;
+    size_t m_size = 0;          // Number of live delegates
+    size_t m_removed = 0;       // Number of empty slots within m_delegates
+    int m_invoking = 0;         // Invocation nesting depth
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,228 @@
+#ifndef _MULTICAST_DELEGATE_RCU_H
+#define _MULTICAST_DELEGATE_RCU_H
+
+// MulticastDelegateRcu.h
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+//
+// Thread-safe multicast delegate using read-copy-update. The invocation list is an
+// immutable snapshot. Invoking takes no lock; subscribing or unsubscribing copies the
+// list and atomically swaps in the new snapshot. A replaced snapshot is deleted once
+// no invoking thread can still be using it.
+
+#include "Delegate.h"
+#include "DelegateOpt.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace DelegateLib {
+
+/// @brief Epoch based reader tracking for read-copy-update. Readers register in the
+/// current epoch; the writer may advance the epoch once no reader remains registered
+/// in the previous one. An object replaced during epoch N is unreachable by every
+/// reader once the epoch has advanced twice. Epochs are numbered modulo EPOCHS.
+/// @details Each epoch has DELEGATE_RCU_SHARDS reader counters on separate cache lines.
+/// A thread always uses the same shard, so readers on different threads do not contend.
+class RcuEpoch
+{
+public:
+    static const unsigned EPOCHS = 3;
+
+    RcuEpoch() : m_epoch(0) {}
+
+    /// Register the calling thread as a reader.
+    /// @return The epoch to pass to ReadUnlock().
+    unsigned ReadLock() {
+        while (true)
+        {
+            unsigned epoch = m_epoch.load();
+            std::atomic<size_t>& count = m_readers[epoch][Shard()].count;
+            count.fetch_add(1);
+
+            // The writer may have advanced the epoch before seeing our registration
+            if (m_epoch.load() == epoch)
+                return epoch;
+            count.fetch_sub(1);
+        }
+    }
+
+    /// Unregister the calling thread as a reader.
+    /// @param[in] epoch - the value returned by ReadLock().
+    void ReadUnlock(unsigned epoch) {
+        m_readers[epoch][Shard()].count.fetch_sub(1, std::memory_order_release);
+    }
+
+    /// Advance the epoch if no reader remains in the previous epoch. Writers must be
+    /// serialized by the caller.
+    /// @return True if the epoch advanced.
+    bool TryAdvance() {
+        unsigned epoch = m_epoch.load(std::memory_order_relaxed);
+        if (Readers((epoch + EPOCHS - 1) % EPOCHS) != 0)
+            return false;
+        m_epoch.store((epoch + 1) % EPOCHS);
+        return true;
+    }
+
+    /// @return The current epoch, from 0 to EPOCHS - 1.
+    unsigned Epoch() const { return m_epoch.load(std::memory_order_relaxed); }
+
+private:
+    RcuEpoch(const RcuEpoch&) = delete;
+    RcuEpoch& operator=(const RcuEpoch&) = delete;
+
+    /// @return The number of readers registered in epoch slot index.
+    size_t Readers(unsigned index) const {
+        size_t readers = 0;
+        for (auto& shard : m_readers[index])
+            readers += shard.count.load();
+        return readers;
+    }
+
+    /// @return The reader counter shard used by the calling thread.
+    static size_t Shard() {
+        static std::atomic<size_t> nextShard(0);
+        thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % DELEGATE_RCU_SHARDS;
+        return shard;
+    }
+
+    struct alignas(64) Counter
+    {
+        std::atomic<size_t> count{ 0 };
+    };
+
+    std::atomic<unsigned> m_epoch;
+    Counter m_readers[EPOCHS][DELEGATE_RCU_SHARDS];
+};
+
+template <class R>
+struct MulticastDelegateRcu; // Not defined
+
+/// @brief Thread-safe multicast delegate container class with a lock-free invoke.
+/// Concurrent invokers do not serialize, and a slow callback never blocks operator+=
+/// or operator-=. A callback may add or remove delegates, including itself, on the
+/// container invoking it; the change applies from the next invocation.
+/// @details Concurrent invokers call the same stored delegate instance at the same 
+/// time, so every stored delegate must be safe for concurrent invocation. The 
+/// synchronous and non-blocking asynchronous delegates are. DelegateFreeAsyncWait<> 
+/// and DelegateMemberAsyncWait<> are not, as each invocation records its result within
+/// the delegate; store them in a MulticastDelegateSafe<> instead.
+/// MulticastDelegateRcu<> does not support return values. A void return must always
+/// be used.
+template<class RetType, class... Args>
+class MulticastDelegateRcu<RetType(Args...)>
+{
+public:
+    MulticastDelegateRcu() : m_list(nullptr) {}
+
+    /// Destructor. The container must not be invoked concurrently with its destruction.
+    ~MulticastDelegateRcu() {
+        delete m_list.load();
+        for (auto& retired : m_retired)
+            for (auto list : retired)
+                delete list;
+    }
+
+    RetType operator()(Args... args) {
+        ReadGuard guard(m_rcu);
+        const DelegateList* list = m_list.load();
+        if (list)
+        {
+            for (auto& delegate : *list)
+                (*delegate)(args...);	// Invoke delegate callback
+        }
+    }
+
+    void operator+=(const Delegate<RetType(Args...)>& delegate) {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        const DelegateList* list = m_list.load();
+        DelegateList* newList = list ? new DelegateList(*list) : new DelegateList();
+        newList->emplace_back(delegate.Clone());
+        Replace(newList);
+    }
+    void operator-=(const Delegate<RetType(Args...)>& delegate) {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        const DelegateList* list = m_list.load();
+        if (!list)
+            return;
+        for (auto it = list->begin(); it != list->end(); ++it)
+        {
+            if (*((DelegateBase*)&delegate) == *((DelegateBase*)it->get()))
+            {
+                DelegateList* newList = nullptr;
+                if (list->size() > 1)
+                {
+                    newList = new DelegateList(list->begin(), it);
+                    newList->insert(newList->end(), it + 1, list->end());
+                }
+                Replace(newList);
+                break;
+            }
+        }
+    }
+
+    /// Any registered delegates?
+    bool Empty() const { return m_list.load() == nullptr; }
+
+    /// Removal all registered delegates.
+    void Clear() {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        Replace(nullptr);
+    }
+
+    explicit operator bool() const { return !Empty(); }
+
+private:
+    // Prevent copying objects
+    MulticastDelegateRcu(const MulticastDelegateRcu&) = delete;
+    MulticastDelegateRcu& operator=(const MulticastDelegateRcu&) = delete;
+
+    /// An invocation list snapshot. Delegates are shared between snapshots, so a
+    /// copy costs one reference count increment per delegate.
+    typedef std::vector<std::shared_ptr<Delegate<RetType(Args...)>>> DelegateList;
+
+    /// Registers the calling thread as a reader for the guard's lifetime
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(RcuEpoch& rcu) : m_rcu(rcu), m_epoch(rcu.ReadLock()) {}
+        ~ReadGuard() { m_rcu.ReadUnlock(m_epoch); }
+    private:
+        RcuEpoch& m_rcu;
+        const unsigned m_epoch;
+    };
+
+    /// Publish a new snapshot and retire the old one. The caller must hold m_lock.
+    /// @param[in] newList - the new snapshot, or nullptr if empty.
+    void Replace(const DelegateList* newList) {
+        const DelegateList* oldList = m_list.exchange(newList);
+        if (oldList)
+            m_retired[m_rcu.Epoch()].push_back(oldList);
+
+        // Delete the snapshots replaced two epochs ago. Without concurrent readers, 
+        // two advances delete the old snapshot immediately.
+        for (int i = 0; i < 2 && m_rcu.TryAdvance(); i++)
+        {
+            auto& retired = m_retired[(m_rcu.Epoch() + 1) % RcuEpoch::EPOCHS];
+            for (auto list : retired)
+                delete list;
+            retired.clear();
+        }
+    }
+
+    /// The current invocation list snapshot, or nullptr if empty
+    std::atomic<const DelegateList*> m_list;
+
+    /// Replaced snapshots awaiting deletion, indexed by the epoch replaced in
+    std::vector<const DelegateList*> m_retired[RcuEpoch::EPOCHS];
+
+    /// Lock serializing writers. Never taken by operator().
+    std::mutex m_lock;
+
+    RcuEpoch m_rcu;
+};
+
+}
+
+#endif
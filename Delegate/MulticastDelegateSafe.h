@@ -2,7 +2,9 @@
 #define _MULTICAST_DELEGATE_SAFE_H
 
 #include "MulticastDelegate.h"
+#include <atomic>
 #include <mutex>
+#include <thread>
 
 namespace DelegateLib {
 
@@ -10,16 +12,20 @@ template <class R>
 struct MulticastDelegateSafe; // Not defined
 
 /// @brief Thread-safe multicast delegate container class. 
+/// @details A DelegateConnection returned by operator+= may be disconnected or queried
+/// from any thread, including from a callback invoked by this container; removals made
+/// by a callback take effect once the invocation completes. As with operator-=, a
+/// callback must not call the container's own members.
 template<class RetType, class... Args>
 class MulticastDelegateSafe<RetType(Args...)> : public MulticastDelegate<RetType(Args...)>
 {
 public:
     MulticastDelegateSafe() = default;
-    ~MulticastDelegateSafe() = default;
+    ~MulticastDelegateSafe() { this->DetachConnections(); }
 
-    void operator+=(const Delegate<RetType(Args...)>& delegate) {
+    DelegateConnection operator+=(const Delegate<RetType(Args...)>& delegate) {
         const std::lock_guard<std::mutex> lock(m_lock);
-        MulticastDelegate<RetType(Args...)>::operator +=(delegate);
+        return MulticastDelegate<RetType(Args...)>::operator +=(delegate);
     }
     void operator-=(const Delegate<RetType(Args...)>& delegate) {
         const std::lock_guard<std::mutex> lock(m_lock);
@@ -27,7 +33,13 @@ public:
     }
     void operator()(Args... args) {
         const std::lock_guard<std::mutex> lock(m_lock);
-        MulticastDelegate<RetType(Args...)>::operator ()(args...);
+        const InvokeOwner owner(m_owner);
+        MulticastDelegate<RetType(Args...)>::operator ()(std::forward<Args>(args)...);
+    }
+    void Broadcast(Args... args) {
+        const std::lock_guard<std::mutex> lock(m_lock);
+        const InvokeOwner owner(m_owner);
+        MulticastDelegate<RetType(Args...)>::Broadcast(std::forward<Args>(args)...);
     }
     bool Empty() {
         const std::lock_guard<std::mutex> lock(m_lock);
@@ -43,13 +55,41 @@ public:
         return MulticastDelegate<RetType(Args...)>::operator bool();
     }
 
+protected:
+    // A callback invoked by this container already holds m_lock
+    virtual void Disconnect(uint64_t id) override {
+        if (m_owner.load() == std::this_thread::get_id())
+            return MulticastDelegate<RetType(Args...)>::Disconnect(id);
+        const std::lock_guard<std::mutex> lock(m_lock);
+        MulticastDelegate<RetType(Args...)>::Disconnect(id);
+    }
+    virtual bool IsConnected(uint64_t id) override {
+        if (m_owner.load() == std::this_thread::get_id())
+            return MulticastDelegate<RetType(Args...)>::IsConnected(id);
+        const std::lock_guard<std::mutex> lock(m_lock);
+        return MulticastDelegate<RetType(Args...)>::IsConnected(id);
+    }
+
 private:
     // Prevent copying objects
     MulticastDelegateSafe(const MulticastDelegateSafe&) = delete;
     MulticastDelegateSafe& operator=(const MulticastDelegateSafe&) = delete;
 
+    /// Records the invoking thread while m_lock is held
+    class InvokeOwner
+    {
+    public:
+        explicit InvokeOwner(std::atomic<std::thread::id>& owner) : m_owner(owner) { m_owner.store(std::this_thread::get_id()); }
+        ~InvokeOwner() { m_owner.store(std::thread::id()); }
+    private:
+        std::atomic<std::thread::id>& m_owner;
+    };
+
     /// Lock to make the class thread-safe
     std::mutex m_lock;
+
+    /// The thread invoking the delegates, if any
+    std::atomic<std::thread::id> m_owner;
 };
 
 }
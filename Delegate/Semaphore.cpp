@@ -1,34 +1,105 @@
 #include "Semaphore.h"
-#include "Fault.h"
+#include "Futex.h"
+#include <thread>
+
+using namespace std::chrono;
 
 namespace DelegateLib {
 
+std::atomic<int> Semaphore::s_spinCount(64);
+
+namespace {
+
+/// The Semaphore instances cached by one thread
+struct SemaphoreCache
+{
+    ~SemaphoreCache();
+
+    Semaphore* slots[SemaphorePool::MAX_CACHED] = {};
+    int count = 0;
+};
+
+/// Set once the calling thread's cache is destroyed on thread exit. Later releases
+/// delete the Semaphore instead.
+bool& CacheDestroyed()
+{
+    thread_local bool destroyed = false;
+    return destroyed;
+}
+
+/// @return The calling thread's cache, or nullptr once destroyed.
+SemaphoreCache* GetCache()
+{
+    if (CacheDestroyed())
+        return nullptr;
+    thread_local SemaphoreCache cache;
+    return &cache;
+}
+
+SemaphoreCache::~SemaphoreCache()
+{
+    while (count > 0)
+        delete slots[--count];
+    CacheDestroyed() = true;
+}
+
+}
+
+//------------------------------------------------------------------------------
+// TryWait
+//------------------------------------------------------------------------------
+bool Semaphore::TryWait()
+{
+    uint32_t state = SIGNALED;
+    return m_state.load(std::memory_order_relaxed) == SIGNALED &&
+        m_state.compare_exchange_strong(state, IDLE, std::memory_order_acquire);
+}
+
 //------------------------------------------------------------------------------
 // Wait
 //------------------------------------------------------------------------------
-bool Semaphore::Wait(std::chrono::milliseconds timeout)
+bool Semaphore::Wait(milliseconds timeout)
 {
-    std::unique_lock<std::mutex> lk(m_lock);
-    if (timeout == std::chrono::milliseconds::max()) 
+    // Spin briefly; a target function that completes quickly signals before the 
+    // caller pays for parking and waking
+    const int spinCount = GetSpinCount();
+    for (int i = 0; i < spinCount; i++)
     {
-        m_sema.wait(lk, [this] { return m_signaled; });
+        if (TryWait())
+            return true;
+        std::this_thread::yield();
     }
-    else 
+
+    const auto start = steady_clock::now();
+    const bool infinite = timeout >= duration_cast<milliseconds>(steady_clock::time_point::max() - start);
+    const auto deadline = infinite ? steady_clock::time_point::max() : start + timeout;
+
+    while (1)
     {
-        if (!m_sema.wait_for(lk, timeout, [this] { return m_signaled; })) 
+        uint32_t state = m_state.load(std::memory_order_relaxed);
+        if (state == SIGNALED)
         {
-            return false; // Timeout occurred
+            if (m_state.compare_exchange_weak(state, IDLE, std::memory_order_acquire))
+                return true;
+            continue;
         }
-    }
 
-    if (m_signaled) 
-    {
-        m_signaled = false;
-        return true;
-    }
-    else 
-    {
-        return false;
+        // Announce the waiter in the word itself, so Signal() learns whether to wake 
+        // from the same exchange that publishes the signal
+        if (state == IDLE && !m_state.compare_exchange_weak(state, PARKED, std::memory_order_relaxed))
+            continue;
+
+        auto remaining = nanoseconds::max();
+        if (!infinite)
+        {
+            const auto now = steady_clock::now();
+            if (now >= deadline)
+                return false;   // Timeout occurred
+            remaining = deadline - now;
+        }
+
+        // Returns at once if Signal() changed the word after it was read
+        FutexWait(m_state, PARKED, remaining);
     }
 }
 
@@ -37,11 +108,37 @@ bool Semaphore::Wait(std::chrono::milliseconds timeout)
 //------------------------------------------------------------------------------
 void Semaphore::Signal()
 {
-	{
-		std::unique_lock<std::mutex> lk(m_lock);
-		m_signaled = true;
-	}
-	m_sema.notify_one();
+    // The waiter may destroy the object as soon as it sees the signal. FutexWake() 
+    // only passes the word's address to the kernel, it does not access the object.
+    // Every parked thread wakes, so those not taking the signal park again.
+    if (m_state.exchange(SIGNALED, std::memory_order_acq_rel) == PARKED)
+        FutexWake(m_state, true);
+}
+
+//------------------------------------------------------------------------------
+// Acquire
+//------------------------------------------------------------------------------
+SemaphorePool::Ptr SemaphorePool::Acquire()
+{
+    SemaphoreCache* cache = GetCache();
+    if (cache && cache->count > 0)
+        return Ptr(cache->slots[--cache->count]);
+    return Ptr(new Semaphore());
+}
+
+//------------------------------------------------------------------------------
+// Release
+//------------------------------------------------------------------------------
+void SemaphorePool::Release::operator()(Semaphore* sema) const
+{
+    // A Semaphore signaled after its waiter timed out still holds the signal
+    sema->Reset();
+
+    SemaphoreCache* cache = GetCache();
+    if (cache && cache->count < MAX_CACHED)
+        cache->slots[cache->count++] = sema;
+    else
+        delete sema;
 }
 
 }
@@ -1,14 +1,19 @@
-#ifndef _SEMAPHORE_H
-#define _SEMAPHORE_H
+#ifndef _DELEGATE_SEMAPHORE_H
+#define _DELEGATE_SEMAPHORE_H
 
 #include "DelegateOpt.h"
-#include <condition_variable>
-#include <mutex>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 
 namespace DelegateLib {
 
-/// @brief A semaphore wrapper class. 
+/// @brief A binary semaphore built on an atomic word. Wait() spins briefly before
+/// parking on the word using FutexWait(), so a signal arriving within the spin costs
+/// no system calls and Signal() only issues a wake when a thread is parked. Signal()
+/// does not access the object once the signal is visible, so the waiter may destroy
+/// or reuse it as soon as Wait() returns true.
 class Semaphore
 {
 public:
@@ -17,22 +22,63 @@ public:
 
 	/// Called to wait on a semaphore to be signaled.
 	/// @param[in] timeout - timeout in milliseconds
-	/// @return Return true if semaphore signaled, false if timeout occurred. 
+	/// @return Return true if semaphore signaled, false if timeout occurred.
 	bool Wait(std::chrono::milliseconds timeout);
 
 	/// Called to signal a semaphore.
 	void Signal();
 
+	/// Clear a pending signal. Only call when no thread is waiting or signaling.
+	void Reset() { m_state.store(IDLE, std::memory_order_relaxed); }
+
+	/// Set the number of times Wait() polls, yielding between polls, before parking.
+	/// @param[in] spinCount - the spin count. 0 parks immediately.
+	static void SetSpinCount(int spinCount) { s_spinCount.store(spinCount, std::memory_order_relaxed); }
+
+	/// @return The number of polls before parking.
+	static int GetSpinCount() { return s_spinCount.load(std::memory_order_relaxed); }
+
 private:
 	// Prevent copying objects
 	Semaphore(const Semaphore&) = delete;
 	Semaphore& operator=(const Semaphore&) = delete;
 
-	std::condition_variable m_sema;
-	std::mutex m_lock;
-	bool m_signaled = false;
+	/// Consume a pending signal.
+	/// @return True if the semaphore was signaled.
+	bool TryWait();
+
+	static const uint32_t IDLE = 0;		// Not signaled
+	static const uint32_t SIGNALED = 1;	// Signaled and not yet consumed
+	static const uint32_t PARKED = 2;	// Not signaled, and a thread may be parked
+
+	std::atomic<uint32_t> m_state{ IDLE };	// Futex word
+
+	static std::atomic<int> s_spinCount;
+};
+
+/// @brief A per-thread cache of Semaphore instances. A blocking asynchronous call takes
+/// its completion Semaphore from the pool and returns it once signaled, instead of
+/// constructing a new one for every call. After a timeout the delegate clone returns
+/// it once both threads are done with it.
+class SemaphorePool
+{
+public:
+	/// Returns a Semaphore to the calling thread's pool, reset for reuse.
+	struct Release
+	{
+		void operator()(Semaphore* sema) const;
+	};
+
+	using Ptr = std::unique_ptr<Semaphore, Release>;
+
+	/// Take an unsignaled Semaphore from the calling thread's pool, or create one if
+	/// the pool is empty.
+	static Ptr Acquire();
+
+	/// Maximum Semaphore instances cached per thread. Releases beyond this are deleted.
+	static const int MAX_CACHED = 16;
 };
 
 }
 
-#endif 
+#endif
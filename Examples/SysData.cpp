@@ -39,7 +39,8 @@ void SysData::SetSystemMode(SystemMode::Type systemMode)
 	// Update the system mode
 	m_systemMode = systemMode;
 
-	// Callback all registered subscribers
+	// Callback all registered subscribers. The asynchronous subscribers share one 
+	// copy of callbackData.
 	if (SystemModeChangedDelegate)
-		SystemModeChangedDelegate(callbackData);
+		SystemModeChangedDelegate.Broadcast(callbackData);
 }
\ No newline at end of file
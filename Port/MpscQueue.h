@@ -0,0 +1,87 @@
+#ifndef _MPSC_QUEUE_H
+#define _MPSC_QUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/// @brief An unbounded lock-free multiple producer, single consumer FIFO queue.
+/// Any number of threads may call Push() concurrently. Only one thread may call
+/// Pop() and Empty().
+/// @details The queue is a singly linked list with a dummy node (Dmitry Vyukov's
+/// MPSC algorithm). Push() is a single atomic exchange and never blocks. Pop() can
+/// briefly fail while a producer is between its exchange and linking its node;
+/// Empty() returns false in that window so the consumer knows to retry.
+template <class T>
+class MpscQueue
+{
+public:
+	MpscQueue() : m_head(&m_stub), m_tail(&m_stub) {}
+
+	~MpscQueue()
+	{
+		T value;
+		while (Pop(value)) {}
+		if (m_tail != &m_stub)
+			delete m_tail;
+	}
+
+	/// Add a value to the back of the queue. Safe to call from any thread.
+	/// @param[in] value - the value to add.
+	void Push(T value)
+	{
+		Node* node = new Node(std::move(value));
+		Node* prev = m_head.exchange(node, std::memory_order_seq_cst);
+		prev->m_next.store(node, std::memory_order_release);
+	}
+
+	/// Remove the value at the front of the queue. Consumer thread only.
+	/// @param[out] value - the removed value.
+	/// @return true if a value was removed, false otherwise.
+	bool Pop(T& value)
+	{
+		Node* tail = m_tail;
+		Node* next = tail->m_next.load(std::memory_order_acquire);
+		if (next == nullptr)
+			return false;
+
+		// The next node becomes the new dummy node
+		value = std::move(next->m_value);
+		m_tail = next;
+		if (tail != &m_stub)
+			delete tail;
+		return true;
+	}
+
+	/// Consumer thread only.
+	/// @return true if the queue is empty and no Push() is in progress.
+	bool Empty() const
+	{
+		return m_tail->m_next.load(std::memory_order_seq_cst) == nullptr &&
+			m_head.load(std::memory_order_seq_cst) == m_tail;
+	}
+
+private:
+	MpscQueue(const MpscQueue&) = delete;
+	MpscQueue& operator=(const MpscQueue&) = delete;
+
+	struct Node
+	{
+		Node() = default;
+		explicit Node(T&& value) : m_value(std::move(value)) {}
+
+		std::atomic<Node*> m_next{ nullptr };
+		T m_value;
+	};
+
+	/// Producers link new nodes after m_head
+	alignas(64) std::atomic<Node*> m_head;
+
+	/// The consumer pops from m_tail (the current dummy node). Kept on a separate
+	/// cache line from m_head so producers and the consumer do not false share.
+	alignas(64) Node* m_tail;
+
+	/// Initial dummy node
+	Node m_stub;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _RING_BUFFER_H
+#define _RING_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/// @brief A growable circular FIFO buffer. Storage is allocated up front and reused,
+/// so once the buffer reaches its working size Push() and Pop() never allocate. When 
+/// full, the capacity doubles. The class is not thread-safe. 
+template <class T>
+class RingBuffer
+{
+public:
+	/// Constructor
+	/// @param[in] capacity - initial capacity. Rounded up to a power of two.
+	explicit RingBuffer(size_t capacity = 64)
+	{
+		m_capacity = 1;
+		while (m_capacity < capacity)
+			m_capacity <<= 1;
+		m_buffer.reset(new T[m_capacity]);
+	}
+
+	/// Add a value to the back of the buffer.
+	/// @param[in] value - the value to move into the buffer.
+	void Push(T&& value)
+	{
+		if (m_size == m_capacity)
+			Grow();
+		m_buffer[(m_head + m_size) & (m_capacity - 1)] = std::move(value);
+		m_size++;
+	}
+
+	/// @return The value at the front of the buffer.
+	/// @pre The buffer is not empty.
+	T& Front() { return m_buffer[m_head]; }
+
+	/// Remove the value at the front of the buffer. The slot is reset to a default 
+	/// constructed T so any resources held by the value are released.
+	/// @pre The buffer is not empty.
+	void Pop()
+	{
+		m_buffer[m_head] = T();
+		m_head = (m_head + 1) & (m_capacity - 1);
+		m_size--;
+	}
+
+	/// @param[in] index - position from the front of the buffer.
+	/// @return The value at index.
+	/// @pre index < Size().
+	T& operator[](size_t index) { return m_buffer[(m_head + index) & (m_capacity - 1)]; }
+
+	/// Remove the value at index, moving the values behind it forward one position.
+	/// @param[in] index - position from the front of the buffer.
+	/// @pre index < Size().
+	void Erase(size_t index)
+	{
+		for (size_t i = index; i + 1 < m_size; i++)
+			(*this)[i] = std::move((*this)[i + 1]);
+		(*this)[m_size - 1] = T();
+		m_size--;
+	}
+
+	bool Empty() const { return m_size == 0; }
+	size_t Size() const { return m_size; }
+	size_t Capacity() const { return m_capacity; }
+
+	/// Exchange the contents of two buffers in constant time.
+	void Swap(RingBuffer& other)
+	{
+		std::swap(m_buffer, other.m_buffer);
+		std::swap(m_capacity, other.m_capacity);
+		std::swap(m_head, other.m_head);
+		std::swap(m_size, other.m_size);
+	}
+
+private:
+	RingBuffer(const RingBuffer&) = delete;
+	RingBuffer& operator=(const RingBuffer&) = delete;
+
+	void Grow()
+	{
+		std::unique_ptr<T[]> buffer(new T[m_capacity * 2]);
+		for (size_t i = 0; i < m_size; i++)
+			buffer[i] = std::move(m_buffer[(m_head + i) & (m_capacity - 1)]);
+		m_buffer = std::move(buffer);
+		m_capacity *= 2;
+		m_head = 0;
+	}
+
+	std::unique_ptr<T[]> m_buffer;
+	size_t m_capacity = 0;
+	size_t m_head = 0;
+	size_t m_size = 0;
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef _THREAD_MSG_H
 #define _THREAD_MSG_H
 
+#include "DelegateMsg.h"
+#include "DelegateMsgInline.h"
 #ifdef USE_XALLOCATOR
 	#include "xallocator.h"
 #endif
@@ -13,6 +15,10 @@ class ThreadMsg
 	XALLOCATOR
 #endif
 public:
+	/// Default constructor. Creates an empty message for use by queues that
+	/// store messages by value. 
+	ThreadMsg() : m_id(0) {}
+
 	/// Constructor
 	/// @param[in] id - a unique identifier for the thread messsage
 	/// @param[in] data - a pointer to the messsage data to be typecast
@@ -26,12 +32,50 @@ public:
 	{
 	}
 
+	/// Constructor
+	/// @param[in] id - a unique identifier for the thread messsage
+	/// @param[in] inlineMsg - an inline delegate message moved into this message. 
+	ThreadMsg(INT id, DelegateLib::DelegateMsgInline&& inlineMsg) :
+		m_id(id),
+		m_inline(std::move(inlineMsg))
+	{
+	}
+
     INT GetId() const { return m_id; }
-    std::shared_ptr<DelegateLib::DelegateMsgBase> GetData() { return m_data; }
+    const std::shared_ptr<DelegateLib::DelegateMsgBase>& GetData() const { return m_data; }
+    DelegateLib::DelegateMsgInline& GetInline() { return m_inline; }
+
+	/// @return The dispatch priority of the delegate message, or NORMAL if none.
+	DelegateLib::DelegatePriority GetPriority() const
+	{
+		if (m_data)
+			return m_data->GetPriority();
+		if (!m_inline.Empty())
+			return m_inline.GetPriority();
+		return DelegateLib::DelegatePriority::NORMAL;
+	}
+
+	/// @return The coalesce key of the delegate message, or nullptr if none.
+	const void* GetCoalesceKey() const
+	{
+		if (m_data)
+			return m_data->GetCoalesceKey();
+		return m_inline.GetCoalesceKey();
+	}
+
+	/// @return True if a queue may discard this message. Messages without a delegate,
+	///		such as a thread exit request, are never discarded.
+	bool IsDiscardable() const
+	{
+		if (m_data)
+			return m_data->IsDiscardable();
+		return !m_inline.Empty() && m_inline.IsDiscardable();
+	}
 
 private:
     INT m_id;
     std::shared_ptr<DelegateLib::DelegateMsgBase> m_data;
+    DelegateLib::DelegateMsgInline m_inline;
 };
 
 #endif
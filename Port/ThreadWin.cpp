@@ -59,13 +59,14 @@ void ThreadWin::PostThreadMessage(UINT msg, void* data)
 //----------------------------------------------------------------------------
 // DispatchDelegate
 //----------------------------------------------------------------------------
-void ThreadWin::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
+bool ThreadWin::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
 {
 	// Create a new ThreadMsg
 	ThreadMsg* threadMsg = new ThreadMsg(WM_DISPATCH_DELEGATE, msg);
 
 	// Post the message to the this thread's message queue
 	PostThreadMessage(WM_DISPATCH_DELEGATE, threadMsg);
+	return true;
 }
 
 //----------------------------------------------------------------------------
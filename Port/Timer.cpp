@@ -1,131 +1,395 @@
 #include "Timer.h"
 #include "Fault.h"
 #include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
-std::mutex Timer::m_lock;
-bool Timer::m_timerStopped = false;
-list<Timer*> Timer::m_timers;
+/// @brief Services every Timer instance from one thread. Timers are held in a
+/// binary min-heap ordered by expiration time; each Timer stores its own heap
+/// index so Start() and Stop() are O(log n). The thread sleeps until the earliest
+/// deadline, or until a timer with an earlier deadline is started.
+/// @details A manual timer service has no thread. Its time only moves forward
+/// when Advance() is called, which invokes the expired timers on the caller's thread.
+class TimerService
+{
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	/// Get the single timer service instance driven by std::chrono::steady_clock.
+	static TimerService& GetInstance()
+	{
+		static TimerService instance(false);
+		return instance;
+	}
+
+	/// Constructor
+	/// @param[in] manual - true if time is advanced by Advance() rather than by steady_clock.
+	explicit TimerService(bool manual) : m_manual(manual), m_running(nullptr), m_exit(false) {}
+
+	~TimerService();
+
+	/// Schedule a timer to expire after timeout, replacing any existing schedule.
+	void Start(Timer* timer, std::chrono::nanoseconds timeout);
+
+	/// Remove a timer from the schedule and wait for a running callback.
+	void Stop(Timer* timer);
+
+	/// Get the current time of this service.
+	TimePoint Now();
+
+	/// Move a manual service's time forward and invoke every expired timer.
+	void Advance(std::chrono::nanoseconds duration);
+
+private:
+	TimerService(const TimerService&) = delete;
+	TimerService& operator=(const TimerService&) = delete;
+
+	/// Entry point for the timer thread
+	void Process();
+
+	/// Reschedule the earliest timer, which has expired at now, and invoke its
+	/// Expired callback with the lock released.
+	void Expire(std::unique_lock<std::mutex>& lock, TimePoint now);
+
+	/// @return The current time. The caller must hold m_lock.
+	TimePoint NowLocked() const { return m_manual ? m_manualNow : std::chrono::steady_clock::now(); }
+
+	void Push(Timer* timer);
+	void Remove(Timer* timer);
+	void SiftUp(size_t index);
+	void SiftDown(size_t index);
+	void Swap(size_t a, size_t b);
+
+	/// Returns true if timer a expires before timer b
+	bool Earlier(size_t a, size_t b) const { return m_heap[a]->m_expireTime < m_heap[b]->m_expireTime; }
+
+	std::mutex m_lock;
+	std::condition_variable m_cv;
+	std::condition_variable m_runningCv;
+	std::vector<Timer*> m_heap;
+	std::thread m_thread;
+
+	const bool m_manual;
+
+	/// The current time of a manual service
+	TimePoint m_manualNow;
+
+	/// The thread invoking the m_running callback
+	std::thread::id m_runningThread;
+
+	/// The timer whose Expired callback is executing on the timer thread, if any
+	Timer* m_running;
+	bool m_exit;
+};
 
 //------------------------------------------------------------------------------
-// TimerDisabled
+// ~TimerService
 //------------------------------------------------------------------------------
-static bool TimerDisabled(Timer* value)
+TimerService::~TimerService()
 {
-	return !(value->Enabled());
+	{
+		const std::lock_guard<std::mutex> lock(m_lock);
+		m_exit = true;
+	}
+	m_cv.notify_one();
+	if (m_thread.joinable())
+		m_thread.join();
 }
 
 //------------------------------------------------------------------------------
-// Constructor
+// Start
 //------------------------------------------------------------------------------
-Timer::Timer()
+void TimerService::Start(Timer* timer, std::chrono::nanoseconds timeout)
 {
 	const std::lock_guard<std::mutex> lock(m_lock);
-	m_enabled = false;
+
+	timer->m_timeout = timeout;
+	timer->m_expireTime = NowLocked() + timeout;
+	timer->m_enabled = true;
+
+	// Remove the existing entry, if any, to prevent duplicates in the heap
+	Remove(timer);
+	Push(timer);
+
+	// Start the timer thread on first use
+	if (!m_manual && !m_thread.joinable())
+		m_thread = std::thread(&TimerService::Process, this);
+
+	// Wake the timer thread if this is now the earliest deadline
+	if (timer->m_heapIndex == 0)
+		m_cv.notify_one();
 }
 
 //------------------------------------------------------------------------------
-// Destructor
+// Stop
 //------------------------------------------------------------------------------
-Timer::~Timer()
+void TimerService::Stop(Timer* timer)
 {
-	const std::lock_guard<std::mutex> lock(m_lock);
-	m_timers.remove(this);
+	std::unique_lock<std::mutex> lock(m_lock);
+
+	timer->m_enabled = false;
+	Remove(timer);
+
+	// Wait for a callback in progress, unless the callback itself is stopping the timer
+	if (std::this_thread::get_id() != m_runningThread)
+	{
+		while (m_running == timer)
+			m_runningCv.wait(lock);
+	}
 }
 
 //------------------------------------------------------------------------------
-// Start
+// Now
 //------------------------------------------------------------------------------
-void Timer::Start(std::chrono::milliseconds timeout)
+TimerService::TimePoint TimerService::Now()
 {
 	const std::lock_guard<std::mutex> lock(m_lock);
+	return NowLocked();
+}
 
-	m_timeout = timeout;
-	ASSERT_TRUE(m_timeout != std::chrono::milliseconds(0));
-	m_expireTime = GetTime();
-	m_enabled = true;
+//------------------------------------------------------------------------------
+// Advance
+//------------------------------------------------------------------------------
+void TimerService::Advance(std::chrono::nanoseconds duration)
+{
+	ASSERT_TRUE(m_manual);
 
-	// Remove the existing entry, if any, to prevent duplicates in the list
-	m_timers.remove(this);
+	std::unique_lock<std::mutex> lock(m_lock);
+	m_manualNow += duration;
+	const TimePoint now = m_manualNow;
 
-	// Add this timer to the list for servicing
-	m_timers.push_back(this);
+	// Each expired timer is rescheduled past now, so every timer fires at most once
+	while (!m_heap.empty() && m_heap[0]->m_expireTime <= now)
+		Expire(lock, now);
 }
 
 //------------------------------------------------------------------------------
-// Stop
+// Process
 //------------------------------------------------------------------------------
-void Timer::Stop()
+void TimerService::Process()
 {
-	const std::lock_guard<std::mutex> lock(m_lock);
+	std::unique_lock<std::mutex> lock(m_lock);
+	while (!m_exit)
+	{
+		if (m_heap.empty())
+		{
+			m_cv.wait(lock);
+			continue;
+		}
+
+		// Sleep until the earliest deadline or until woken by Start()
+		TimePoint expireTime = m_heap[0]->m_expireTime;
+		TimePoint now = std::chrono::steady_clock::now();
+		if (expireTime > now)
+		{
+			m_cv.wait_until(lock, expireTime);
+			continue;
+		}
 
-	m_enabled = false;
-	m_timerStopped = true;
+		Expire(lock, now);
+	}
 }
 
 //------------------------------------------------------------------------------
-// CheckExpired
+// Expire
 //------------------------------------------------------------------------------
-void Timer::CheckExpired()
+void TimerService::Expire(std::unique_lock<std::mutex>& lock, TimePoint now)
 {
-	if (!m_enabled)
-		return;
-
-	// Has the timer expired?
-	if (Difference(m_expireTime, GetTime()) < m_timeout)
-		return;
+	Timer* timer = m_heap[0];
 
-	// Increment the timer to the next expiration
-	m_expireTime += m_timeout;
+	// Increment the timer to the next expiration. The deadline advances from the
+	// previous deadline, not from now, so periodic callbacks do not drift.
+	timer->m_expireTime += timer->m_timeout;
 
 	// Is the timer already expired after we incremented above?
-	if (Difference(m_expireTime, GetTime()) > m_timeout)
+	if (timer->m_expireTime <= now)
 	{
-		// The timer has fallen behind so set time expiration further forward.
-		m_expireTime = GetTime();
+		// The timer has fallen behind so skip the missed periods, keeping the 
+		// timer in phase with its original schedule.
+		auto missed = (now - timer->m_expireTime) / timer->m_timeout + 1;
+		timer->m_expireTime += missed * timer->m_timeout;
 	}
+	SiftDown(0);
 
-	// Call the client's expired callback function
-	if (Expired)
-		Expired();
+	// Call the client's expired callback function without holding the lock
+	m_running = timer;
+	m_runningThread = std::this_thread::get_id();
+	lock.unlock();
+	if (timer->Expired)
+		timer->Expired();
+	lock.lock();
+	m_running = nullptr;
+	m_runningThread = std::thread::id();
+	m_runningCv.notify_all();
 }
 
 //------------------------------------------------------------------------------
-// Difference
+// Push
 //------------------------------------------------------------------------------
-std::chrono::milliseconds Timer::Difference(std::chrono::milliseconds time1, std::chrono::milliseconds time2)
+void TimerService::Push(Timer* timer)
 {
-	return (time2 - time1);
+	timer->m_heapIndex = m_heap.size();
+	m_heap.push_back(timer);
+	SiftUp(timer->m_heapIndex);
 }
 
 //------------------------------------------------------------------------------
-// ProcessTimers
+// Remove
 //------------------------------------------------------------------------------
-void Timer::ProcessTimers()
+void TimerService::Remove(Timer* timer)
 {
-	const std::lock_guard<std::mutex> lock(m_lock);
+	size_t index = timer->m_heapIndex;
+	if (index == Timer::NOT_QUEUED)
+		return;
+
+	// Move the last timer into the vacated slot and restore the heap order
+	size_t last = m_heap.size() - 1;
+	if (index != last)
+		Swap(index, last);
+	m_heap.pop_back();
+	timer->m_heapIndex = Timer::NOT_QUEUED;
+
+	if (index < m_heap.size())
+	{
+		SiftUp(index);
+		SiftDown(index);
+	}
+}
 
-	// Remove disabled timer from the list if stopped
-	if (m_timerStopped)
+//------------------------------------------------------------------------------
+// SiftUp
+//------------------------------------------------------------------------------
+void TimerService::SiftUp(size_t index)
+{
+	while (index > 0)
 	{
-		m_timers.remove_if(TimerDisabled);
-		m_timerStopped = false;
+		size_t parent = (index - 1) / 2;
+		if (!Earlier(index, parent))
+			break;
+		Swap(index, parent);
+		index = parent;
 	}
+}
 
-	// Iterate through each timer and check for expirations
-	TimersIterator it;
-	for (it = m_timers.begin(); it != m_timers.end(); it++)
+//------------------------------------------------------------------------------
+// SiftDown
+//------------------------------------------------------------------------------
+void TimerService::SiftDown(size_t index)
+{
+	while (true)
 	{
-		if ((*it) != NULL)
-			(*it)->CheckExpired();
+		size_t left = index * 2 + 1;
+		size_t right = left + 1;
+		size_t smallest = index;
+		if (left < m_heap.size() && Earlier(left, smallest))
+			smallest = left;
+		if (right < m_heap.size() && Earlier(right, smallest))
+			smallest = right;
+		if (smallest == index)
+			break;
+		Swap(index, smallest);
+		index = smallest;
 	}
 }
 
+//------------------------------------------------------------------------------
+// Swap
+//------------------------------------------------------------------------------
+void TimerService::Swap(size_t a, size_t b)
+{
+	std::swap(m_heap[a], m_heap[b]);
+	m_heap[a]->m_heapIndex = a;
+	m_heap[b]->m_heapIndex = b;
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+// Constructing the timer service first ensures it outlives every timer
+Timer::Timer() : m_service(&TimerService::GetInstance()), m_enabled(false)
+{
+}
+
+//------------------------------------------------------------------------------
+// Constructor
+//------------------------------------------------------------------------------
+Timer::Timer(ManualTimerClock& clock) : m_service(clock.m_service.get()), m_enabled(false)
+{
+}
+
+//------------------------------------------------------------------------------
+// Destructor
+//------------------------------------------------------------------------------
+Timer::~Timer()
+{
+	m_service->Stop(this);
+}
+
+//------------------------------------------------------------------------------
+// Start
+//------------------------------------------------------------------------------
+void Timer::Start(std::chrono::nanoseconds timeout)
+{
+	ASSERT_TRUE(timeout > std::chrono::nanoseconds(0));
+	m_service->Start(this, timeout);
+}
+
+//------------------------------------------------------------------------------
+// Stop
+//------------------------------------------------------------------------------
+void Timer::Stop()
+{
+	m_service->Stop(this);
+}
+
+//------------------------------------------------------------------------------
+// Difference
+//------------------------------------------------------------------------------
+std::chrono::milliseconds Timer::Difference(std::chrono::milliseconds time1, std::chrono::milliseconds time2)
+{
+	return (time2 - time1);
+}
+
+//------------------------------------------------------------------------------
+// GetTime
+//------------------------------------------------------------------------------
 std::chrono::milliseconds Timer::GetTime()
 {
-	auto duration = std::chrono::system_clock::now().time_since_epoch();
+	auto duration = std::chrono::steady_clock::now().time_since_epoch();
 	auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(duration);
 	return millis;
 }
 
+//------------------------------------------------------------------------------
+// ManualTimerClock
+//------------------------------------------------------------------------------
+ManualTimerClock::ManualTimerClock() : m_service(new TimerService(true))
+{
+}
+
+//------------------------------------------------------------------------------
+// ~ManualTimerClock
+//------------------------------------------------------------------------------
+ManualTimerClock::~ManualTimerClock()
+{
+}
+
+//------------------------------------------------------------------------------
+// Now
+//------------------------------------------------------------------------------
+std::chrono::steady_clock::time_point ManualTimerClock::Now() const
+{
+	return m_service->Now();
+}
+
+//------------------------------------------------------------------------------
+// Advance
+//------------------------------------------------------------------------------
+void ManualTimerClock::Advance(std::chrono::nanoseconds duration)
+{
+	m_service->Advance(duration);
+}
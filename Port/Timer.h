@@ -2,13 +2,55 @@
 #define _TIMER_H
 
 #include "DelegateLib.h"
-#include <mutex>
-#include <list>
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 using namespace DelegateLib;
 
-/// @brief A timer class provides periodic timer callbacks on the client's 
+class TimerService;
+
+/// @brief A clock advanced manually by the client instead of by real time,
+/// e.g. a fake clock for unit tests or a simulation. Timers constructed with a
+/// ManualTimerClock expire only when Advance() is called.
+class ManualTimerClock
+{
+public:
+	/// Constructor. The clock starts at time zero.
+	ManualTimerClock();
+
+	/// Destructor. All timers using this clock must be destroyed first.
+	~ManualTimerClock();
+
+	/// Get the current time of this clock.
+	std::chrono::steady_clock::time_point Now() const;
+
+	/// Moves the clock forward and invokes Expired on every timer due, in deadline
+	/// order, on the calling thread.
+	/// @param[in]	duration - the amount of time to advance the clock.
+	void Advance(std::chrono::nanoseconds duration);
+
+private:
+	friend class Timer;
+
+	ManualTimerClock(const ManualTimerClock&) = delete;
+	ManualTimerClock& operator=(const ManualTimerClock&) = delete;
+
+	std::unique_ptr<TimerService> m_service;
+};
+
+/// @brief A timer class provides periodic timer callbacks on the client's
 /// thread of control. Timer is thread safe.
+/// @details All timers are serviced by a single timer thread that sleeps until
+/// the earliest deadline. On expiration the timer thread invokes Expired. Bind an
+/// asynchronous delegate to Expired so the callback is dispatched to the owning
+/// thread; a synchronous delegate is invoked on the timer thread itself.
+///
+/// Deadlines are measured with std::chrono::steady_clock at nanosecond precision,
+/// so wall-clock adjustments do not affect timers. Periodic deadlines are computed
+/// from the start time rather than from when the callback ran, so timers do not
+/// drift. A timer that falls more than one period behind skips the missed
+/// expirations and stays in phase with its original schedule.
 class Timer
 {
 public:
@@ -18,22 +60,27 @@ public:
 	/// Constructor
 	Timer(void);
 
-	/// Destructor
+	/// Constructor. The timer is driven by clock rather than by real time.
+	/// @param[in]	clock - the clock. Must outlive the timer.
+	explicit Timer(ManualTimerClock& clock);
+
+	/// Destructor. Waits for an Expired callback running on the timer thread to complete.
 	~Timer(void);
 
 	/// Starts a timer for callbacks on the specified timeout interval.
-	/// @param[in]	timeout - the timeout in milliseconds.
-	void Start(std::chrono::milliseconds timeout);
+	/// @param[in]	timeout - the timeout interval, e.g. std::chrono::microseconds(500).
+	void Start(std::chrono::nanoseconds timeout);
 
-	/// Stops a timer.
+	/// Stops a timer. If an Expired callback is running on the timer thread, waits
+	/// for it to complete unless called from within the callback itself.
 	void Stop();
 
 	/// Gets the enabled state of a timer.
 	/// @return		TRUE if the timer is enabled, FALSE otherwise.
 	bool Enabled() { return m_enabled; }
 
-	/// Get the current time in ticks. 
-	/// @return The current time in ticks. 
+	/// Get the current monotonic time in milliseconds.
+	/// @return The current time in milliseconds.
 	static std::chrono::milliseconds GetTime();
 
 	/// Computes the time difference in ticks between two tick values taking into
@@ -43,28 +90,23 @@ public:
 	/// @return		The time difference in ticks.
 	static std::chrono::milliseconds Difference(std::chrono::milliseconds time1, std::chrono::milliseconds time2);
 
-	/// Called on a periodic basic to service all timer instances. 
-	static void ProcessTimers();
-
 private:
+	friend class TimerService;
+
 	// Prevent inadvertent copying of this object
 	Timer(const Timer&);
 	Timer& operator=(const Timer&);
 
-	/// Called to check for expired timers and callback registered clients.
-	void CheckExpired();
-
-	/// List of all system timers to be serviced.
-	static std::list<Timer*> m_timers;
-	typedef std::list<Timer*>::iterator TimersIterator;
+	/// Index value of a timer not within the timer service heap
+	static const size_t NOT_QUEUED = static_cast<size_t>(-1);
 
-	/// A lock to make this class thread safe.
-	static std::mutex m_lock;
+	TimerService* const m_service;
+	std::chrono::nanoseconds m_timeout = std::chrono::nanoseconds(0);
+	std::chrono::steady_clock::time_point m_expireTime;
+	std::atomic<bool> m_enabled;
 
-	std::chrono::milliseconds m_timeout = std::chrono::milliseconds(0);
-	std::chrono::milliseconds m_expireTime = std::chrono::milliseconds(0);
-	bool m_enabled = false;
-	static bool m_timerStopped;
+	/// Position within the timer service heap. Guarded by the timer service lock.
+	size_t m_heapIndex = NOT_QUEUED;
 };
 
 #endif
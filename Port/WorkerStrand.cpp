@@ -0,0 +1,208 @@
+#include "WorkerStrand.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+using namespace DelegateLib;
+
+#define MSG_DISPATCH_DELEGATE	1
+#define MSG_DISPATCH_INLINE		4
+
+// The strand state whose message the calling thread is executing, if any
+static thread_local const void* t_strand = nullptr;
+
+//----------------------------------------------------------------------------
+// WorkerStrand
+//----------------------------------------------------------------------------
+WorkerStrand::WorkerStrand(DelegateThread& executor) : m_state(std::make_shared<State>(executor))
+{
+}
+
+//----------------------------------------------------------------------------
+// ~WorkerStrand
+//----------------------------------------------------------------------------
+WorkerStrand::~WorkerStrand()
+{
+}
+
+//----------------------------------------------------------------------------
+// IsCurrent
+//----------------------------------------------------------------------------
+bool WorkerStrand::IsCurrent() const
+{
+	return t_strand == m_state.get();
+}
+
+//----------------------------------------------------------------------------
+// SetBatchSize
+//----------------------------------------------------------------------------
+void WorkerStrand::SetBatchSize(size_t batchSize)
+{
+	m_state->batchSize = std::max<size_t>(batchSize, 1);
+}
+
+//----------------------------------------------------------------------------
+// GetBatchSize
+//----------------------------------------------------------------------------
+size_t WorkerStrand::GetBatchSize() const
+{
+	return m_state->batchSize;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegate
+//----------------------------------------------------------------------------
+bool WorkerStrand::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
+{
+	return Post(ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInline
+//----------------------------------------------------------------------------
+bool WorkerStrand::DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg)
+{
+	return Post(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)));
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateBatch
+//----------------------------------------------------------------------------
+size_t WorkerStrand::DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs)
+{
+	for (auto& msg : msgs)
+		m_state->queue.Push(ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+	return Posted(msgs.size()) ? msgs.size() : 0;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInlineBatch
+//----------------------------------------------------------------------------
+size_t WorkerStrand::DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs)
+{
+	for (auto& msg : msgs)
+		m_state->queue.Push(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)));
+	return Posted(msgs.size()) ? msgs.size() : 0;
+}
+
+//----------------------------------------------------------------------------
+// Post
+//----------------------------------------------------------------------------
+bool WorkerStrand::Post(ThreadMsg&& msg)
+{
+	m_state->queue.Push(std::move(msg));
+	return Posted(1);
+}
+
+//----------------------------------------------------------------------------
+// Posted
+//----------------------------------------------------------------------------
+bool WorkerStrand::Posted(size_t count)
+{
+	// The messages are pushed before being counted, so a drain task never counts
+	// a message it cannot pop
+	if (count > 0 && m_state->count.fetch_add(count) == 0 && !Schedule(m_state))
+		return Reject(m_state);
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// Schedule
+//----------------------------------------------------------------------------
+bool WorkerStrand::Schedule(const std::shared_ptr<State>& state)
+{
+	// The drain task carries every queued strand message, so the executor must 
+	// not discard it once queued
+	DelegateMsgInline msg([state]() { Drain(state); });
+	msg.SetDiscardable(false);
+	return state->executor.DispatchDelegateInline(std::move(msg));
+}
+
+//----------------------------------------------------------------------------
+// Reject
+//----------------------------------------------------------------------------
+bool WorkerStrand::Reject(const std::shared_ptr<State>& state)
+{
+	bool accepted = true;
+	while (1)
+	{
+		// No drain task will pop the queued messages. Discard those the executor
+		// would have discarded, and invoke the rest here in order, since other
+		// dispatchers were already told they were queued.
+		const size_t count = state->count.load();
+		for (size_t i = 0; i < count; i++)
+		{
+			ThreadMsg msg;
+			while (!state->queue.Pop(msg))
+				std::this_thread::yield();
+
+			if (msg.IsDiscardable())
+				accepted = false;
+			else
+				Invoke(state, msg);
+		}
+
+		// Messages dispatched meanwhile still need a drain task
+		if (state->count.fetch_sub(count) == count || Schedule(state))
+			return accepted;
+	}
+}
+
+//----------------------------------------------------------------------------
+// Invoke
+//----------------------------------------------------------------------------
+void WorkerStrand::Invoke(const std::shared_ptr<State>& state, ThreadMsg& msg)
+{
+	const void* prevStrand = t_strand;
+	t_strand = state.get();
+
+	switch (msg.GetId())
+	{
+		case MSG_DISPATCH_DELEGATE:
+		{
+			ASSERT_TRUE(msg.GetData() != NULL);
+
+			// Invoke the callback on the calling thread
+			DelegateMsgBase::Invoke(msg.GetData());
+			break;
+		}
+
+		case MSG_DISPATCH_INLINE:
+		{
+			ASSERT_TRUE(!msg.GetInline().Empty());
+
+			// Invoke the callback on the calling thread
+			msg.GetInline().Invoke();
+			break;
+		}
+
+		default:
+			ASSERT();
+	}
+
+	t_strand = prevStrand;
+}
+
+//----------------------------------------------------------------------------
+// Drain
+//----------------------------------------------------------------------------
+void WorkerStrand::Drain(const std::shared_ptr<State>& state)
+{
+	while (1)
+	{
+		const size_t batch = std::min(state->count.load(), state->batchSize.load());
+		for (size_t i = 0; i < batch; i++)
+		{
+			// Pop fails briefly while a producer is between its exchange and linking
+			ThreadMsg msg;
+			while (!state->queue.Pop(msg))
+				std::this_thread::yield();
+			Invoke(state, msg);
+		}
+
+		// Repost rather than loop so strands sharing the executor take turns. If the
+		// executor rejects the repost, keep draining on this task instead.
+		if (state->count.fetch_sub(batch) == batch || Schedule(state))
+			return;
+	}
+}
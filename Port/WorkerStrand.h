@@ -0,0 +1,96 @@
+#ifndef _WORKER_STRAND_H
+#define _WORKER_STRAND_H
+
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+
+#include "IDelegateThread.h"
+#include "DataTypes.h"
+#include "ThreadMsg.h"
+#include "MpscQueue.h"
+#include <atomic>
+#include <memory>
+
+/// @brief A DelegateThread that executes its messages one at a time, in the order
+/// dispatched, on another DelegateThread. The strand behaves as a WorkerThread for
+/// ordering, yet owns no OS thread. Many strands may share one WorkerThreadPool.
+/// @details Dispatching to an idle strand posts a single drain task onto the executor.
+/// The drain task invokes up to GetBatchSize() messages, then reposts itself if more
+/// remain so strands sharing an executor take turns. Dispatching never takes a lock.
+/// If a bounded executor rejects the drain task, the discardable messages queued on the
+/// strand are discarded and the dispatch that scheduled it returns false. Messages that
+/// must not be discarded, e.g. a blocking wait delegate, are invoked on the dispatching
+/// thread instead, still one at a time and in order.
+class WorkerStrand : public DelegateLib::DelegateThread
+{
+public:
+	/// Constructor
+	/// @param[in] executor - the thread or thread pool that runs the messages. Must
+	///		outlive every message dispatched to the strand.
+	WorkerStrand(DelegateLib::DelegateThread& executor);
+
+	/// Destructor. Messages already dispatched still run on the executor.
+	~WorkerStrand();
+
+	/// @return True if called from a message executing on this strand.
+	bool IsCurrent() const;
+
+	/// Set the maximum number of messages one drain task invokes before yielding the
+	/// executor to other work. Default is 64.
+	/// @param[in] batchSize - the number of messages, at least 1.
+	void SetBatchSize(size_t batchSize);
+
+	/// @return The maximum number of messages invoked per drain task.
+	size_t GetBatchSize() const;
+
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
+
+	virtual bool DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg);
+
+	virtual size_t DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs);
+
+	virtual size_t DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs);
+
+private:
+	WorkerStrand(const WorkerStrand&) = delete;
+	WorkerStrand& operator=(const WorkerStrand&) = delete;
+
+	/// Strand state, shared with drain tasks in flight so the strand may be destroyed
+	/// before its messages have run
+	struct State
+	{
+		explicit State(DelegateLib::DelegateThread& executor) : executor(executor) {}
+
+		DelegateLib::DelegateThread& executor;
+		MpscQueue<ThreadMsg> queue;
+
+		/// Number of messages dispatched and not yet invoked. The producer that moves
+		/// the count from zero schedules the drain task.
+		std::atomic<size_t> count{ 0 };
+		std::atomic<size_t> batchSize{ 64 };
+	};
+
+	/// Add messages to the queue and schedule a drain task if the strand was idle
+	/// @return False if the executor rejected the drain task and messages were discarded.
+	bool Post(ThreadMsg&& msg);
+	bool Posted(size_t count);
+
+	/// Post a drain task onto the executor.
+	/// @return False if the executor rejected it, e.g. a full bounded queue.
+	static bool Schedule(const std::shared_ptr<State>& state);
+
+	/// Empty the queue after the executor rejected the drain task. Discardable messages 
+	/// are discarded as the executor would have rejected them; the rest are invoked on
+	/// the calling thread. Only called by the thread that scheduled the drain task.
+	/// @return False if any message was discarded.
+	static bool Reject(const std::shared_ptr<State>& state);
+
+	/// Invoke one strand message on the calling thread
+	static void Invoke(const std::shared_ptr<State>& state, ThreadMsg& msg);
+
+	/// Invoke queued messages on the executor
+	static void Drain(const std::shared_ptr<State>& state);
+
+	std::shared_ptr<State> m_state;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#include "DelegateOpt.h"
+#if USE_STD_THREADS
+
+#include "WorkerThreadMpsc.h"
+#include "Futex.h"
+#include <chrono>
+
+#ifdef WIN32
+#include <Windows.h>
+#endif
+
+using namespace std;
+using namespace DelegateLib;
+
+#define MSG_DISPATCH_DELEGATE	1
+#define MSG_EXIT_THREAD			2
+#define MSG_DISPATCH_INLINE		4
+
+//----------------------------------------------------------------------------
+// WorkerThreadMpsc
+//----------------------------------------------------------------------------
+WorkerThreadMpsc::WorkerThreadMpsc(const CHAR* threadName) : m_thread(nullptr), m_idle(0), m_spinCount(SPIN_COUNT), THREAD_NAME(threadName)
+{
+}
+
+//----------------------------------------------------------------------------
+// ~WorkerThreadMpsc
+//----------------------------------------------------------------------------
+WorkerThreadMpsc::~WorkerThreadMpsc()
+{
+	ExitThread();
+}
+
+//----------------------------------------------------------------------------
+// CreateThread
+//----------------------------------------------------------------------------
+BOOL WorkerThreadMpsc::CreateThread()
+{
+	if (!m_thread)
+	{
+		m_thread = std::unique_ptr<std::thread>(new thread(&WorkerThreadMpsc::Process, this));
+
+#ifdef WIN32
+		// Set the thread name so it shows in the Visual Studio Debug Location toolbar
+		std::wstring wstr(THREAD_NAME.begin(), THREAD_NAME.end());
+		SetThreadDescription(m_thread->native_handle(), wstr.c_str());
+#endif
+	}
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// GetThreadId
+//----------------------------------------------------------------------------
+std::thread::id WorkerThreadMpsc::GetThreadId()
+{
+	ASSERT_TRUE(m_thread != nullptr);
+	return m_thread->get_id();
+}
+
+//----------------------------------------------------------------------------
+// GetCurrentThreadId
+//----------------------------------------------------------------------------
+std::thread::id WorkerThreadMpsc::GetCurrentThreadId()
+{
+	return this_thread::get_id();
+}
+
+//----------------------------------------------------------------------------
+// ExitThread
+//----------------------------------------------------------------------------
+void WorkerThreadMpsc::ExitThread()
+{
+	if (!m_thread)
+		return;
+
+	Post(ThreadMsg(MSG_EXIT_THREAD, 0));
+
+	m_thread->join();
+	m_thread = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegate
+//----------------------------------------------------------------------------
+bool WorkerThreadMpsc::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
+{
+	ASSERT_TRUE(m_thread);
+	Post(ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInline
+//----------------------------------------------------------------------------
+bool WorkerThreadMpsc::DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg)
+{
+	ASSERT_TRUE(m_thread);
+	Post(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)));
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateBatch
+//----------------------------------------------------------------------------
+size_t WorkerThreadMpsc::DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs)
+{
+	ASSERT_TRUE(m_thread);
+
+	// Push the whole batch, then make at most one wake-up call
+	for (auto& msg : msgs)
+		m_queue.Push(ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+	Wake();
+	return msgs.size();
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInlineBatch
+//----------------------------------------------------------------------------
+size_t WorkerThreadMpsc::DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs)
+{
+	ASSERT_TRUE(m_thread);
+
+	for (auto& msg : msgs)
+		m_queue.Push(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)));
+	Wake();
+	return msgs.size();
+}
+
+//----------------------------------------------------------------------------
+// Post
+//----------------------------------------------------------------------------
+void WorkerThreadMpsc::Post(ThreadMsg&& msg)
+{
+	m_queue.Push(std::move(msg));
+	Wake();
+}
+
+//----------------------------------------------------------------------------
+// Wake
+//----------------------------------------------------------------------------
+void WorkerThreadMpsc::Wake()
+{
+	// Only pay for a wake-up system call if the worker is parked. The exchange
+	// ensures a single producer issues the wake.
+	if (m_idle.load(std::memory_order_seq_cst) == 1 && m_idle.exchange(0, std::memory_order_seq_cst) == 1)
+		FutexWake(m_idle);
+}
+
+//----------------------------------------------------------------------------
+// Wait
+//----------------------------------------------------------------------------
+void WorkerThreadMpsc::Wait()
+{
+	// Spin briefly; closely spaced messages avoid the park/wake cost entirely
+	const int spinCount = m_spinCount.load(std::memory_order_relaxed);
+	for (int i = 0; i < spinCount; i++)
+	{
+		if (!m_queue.Empty())
+			return;
+		std::this_thread::yield();
+	}
+
+	// Announce the worker is parking, then re-check the queue. A producer either
+	// sees m_idle set and wakes us, or we see its message here.
+	m_idle.store(1, std::memory_order_seq_cst);
+	if (m_queue.Empty())
+		FutexWait(m_idle, 1);
+	m_idle.store(0, std::memory_order_seq_cst);
+}
+
+//----------------------------------------------------------------------------
+// Process
+//----------------------------------------------------------------------------
+void WorkerThreadMpsc::Process()
+{
+	DelegateThreadScope scope(this);
+
+	while (1)
+	{
+		ThreadMsg msg;
+		if (!m_queue.Pop(msg))
+		{
+			Wait();
+			continue;
+		}
+
+		switch (msg.GetId())
+		{
+			case MSG_DISPATCH_DELEGATE:
+			{
+				ASSERT_TRUE(msg.GetData() != NULL);
+
+				// Invoke the callback on the target thread
+				DelegateMsgBase::Invoke(msg.GetData());
+				break;
+			}
+
+			case MSG_DISPATCH_INLINE:
+			{
+				ASSERT_TRUE(!msg.GetInline().Empty());
+
+				// Invoke the callback on the target thread
+				msg.GetInline().Invoke();
+				break;
+			}
+
+			case MSG_EXIT_THREAD:
+				return;
+
+			default:
+				ASSERT();
+		}
+	}
+}
+
+#endif
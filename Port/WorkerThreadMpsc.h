@@ -0,0 +1,94 @@
+#ifndef _WORKER_THREAD_MPSC_H
+#define _WORKER_THREAD_MPSC_H
+
+// @see https://github.com/endurodave/StdWorkerThread
+// David Lafreniere, Feb 2017.
+
+#include "DelegateOpt.h"
+#if USE_STD_THREADS
+
+#include "IDelegateThread.h"
+#include "DataTypes.h"
+#include "ThreadMsg.h"
+#include "MpscQueue.h"
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+
+/// @brief A worker thread backed by a lock-free multiple producer, single consumer
+/// queue. An alternative to WorkerThread for targets with many posting threads.
+/// @details DispatchDelegate() never takes a lock. The worker spins briefly when
+/// the queue runs dry and then parks on a futex; producers only make a wake-up
+/// system call when the worker is actually parked.
+class WorkerThreadMpsc : public DelegateLib::DelegateThread
+{
+public:
+	/// Constructor
+	/// @param[in] threadName - the thread name.
+	WorkerThreadMpsc(const CHAR* threadName);
+
+	/// Destructor
+	~WorkerThreadMpsc();
+
+	/// Called once to create the worker thread
+	/// @return TRUE if thread is created. FALSE otherise.
+	BOOL CreateThread();
+
+	/// Called once a program exit to exit the worker thread
+	void ExitThread();
+
+	/// Get the ID of this thread instance
+	std::thread::id GetThreadId();
+
+	/// Get the ID of the currently executing thread
+	static std::thread::id GetCurrentThreadId();
+
+	/// Set the number of times the worker polls for new messages, yielding between
+	/// polls, before parking on the futex. Default is 64.
+	/// @param[in] spinCount - the number of polls before parking.
+	void SetSpinCount(int spinCount) { m_spinCount = spinCount; }
+
+	/// @return The number of polls before parking.
+	int GetSpinCount() const { return m_spinCount; }
+
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
+
+	virtual bool DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg);
+
+	virtual size_t DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs);
+
+	virtual size_t DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs);
+
+private:
+	WorkerThreadMpsc(const WorkerThreadMpsc&) = delete;
+	WorkerThreadMpsc& operator=(const WorkerThreadMpsc&) = delete;
+
+	/// Entry point for the thread
+	void Process();
+
+	/// Add a message to the queue and wake the worker if it is parked
+	void Post(ThreadMsg&& msg);
+
+	/// Wake the worker if it is parked
+	void Wake();
+
+	/// Spin, then park the worker until a message is posted
+	void Wait();
+
+	/// Default number of empty polls before the worker parks
+	static const int SPIN_COUNT = 64;
+
+	std::unique_ptr<std::thread> m_thread;
+	MpscQueue<ThreadMsg> m_queue;
+
+	/// 1 while the worker is parked (or about to park) on the futex
+	alignas(64) std::atomic<uint32_t> m_idle;
+
+	std::atomic<int> m_spinCount;
+	const std::string THREAD_NAME;
+};
+
+#endif
+
+#endif
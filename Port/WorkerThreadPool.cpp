@@ -0,0 +1,276 @@
+#include "DelegateOpt.h"
+#if USE_STD_THREADS
+
+#include "WorkerThreadPool.h"
+#include "Futex.h"
+#include <algorithm>
+
+#ifdef WIN32
+#include <Windows.h>
+#endif
+
+using namespace std;
+using namespace DelegateLib;
+
+#define MSG_DISPATCH_DELEGATE	1
+#define MSG_DISPATCH_INLINE		4
+
+// The pool and worker index of the calling thread, if a pool worker
+static thread_local const WorkerThreadPool* t_pool = nullptr;
+static thread_local size_t t_workerIndex = 0;
+
+//----------------------------------------------------------------------------
+// WorkerThreadPool
+//----------------------------------------------------------------------------
+WorkerThreadPool::WorkerThreadPool(const CHAR* threadName, size_t threadCount) :
+	m_pending(0), m_wakeSeq(0), m_sleepers(0), m_next(0), m_exit(false), m_created(false), THREAD_NAME(threadName)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	for (size_t i = 0; i < threadCount; i++)
+		m_workers.emplace_back(new Worker());
+}
+
+//----------------------------------------------------------------------------
+// ~WorkerThreadPool
+//----------------------------------------------------------------------------
+WorkerThreadPool::~WorkerThreadPool()
+{
+	ExitThread();
+}
+
+//----------------------------------------------------------------------------
+// CreateThread
+//----------------------------------------------------------------------------
+BOOL WorkerThreadPool::CreateThread()
+{
+	if (!m_created)
+	{
+		m_exit = false;
+		m_created = true;
+		for (size_t i = 0; i < m_workers.size(); i++)
+		{
+			m_workers[i]->thread = std::thread(&WorkerThreadPool::Process, this, i);
+
+#ifdef WIN32
+			// Set the thread name so it shows in the Visual Studio Debug Location toolbar
+			std::string name = THREAD_NAME + std::to_string(i);
+			std::wstring wstr(name.begin(), name.end());
+			SetThreadDescription(m_workers[i]->thread.native_handle(), wstr.c_str());
+#endif
+		}
+	}
+	return TRUE;
+}
+
+//----------------------------------------------------------------------------
+// ExitThread
+//----------------------------------------------------------------------------
+void WorkerThreadPool::ExitThread()
+{
+	if (!m_created)
+		return;
+
+	m_exit = true;
+	m_wakeSeq.fetch_add(1);
+	FutexWake(m_wakeSeq, true);
+
+	for (auto& worker : m_workers)
+		worker->thread.join();
+	m_created = false;
+}
+
+//----------------------------------------------------------------------------
+// IsPoolThread
+//----------------------------------------------------------------------------
+bool WorkerThreadPool::IsPoolThread() const
+{
+	return t_pool == this;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegate
+//----------------------------------------------------------------------------
+bool WorkerThreadPool::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
+{
+	ASSERT_TRUE(m_created);
+	Post(SelectWorker(), 1, [&msg](std::deque<ThreadMsg>& queue) {
+		queue.emplace_back(MSG_DISPATCH_DELEGATE, msg);
+	});
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInline
+//----------------------------------------------------------------------------
+bool WorkerThreadPool::DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg)
+{
+	ASSERT_TRUE(m_created);
+	Post(SelectWorker(), 1, [&msg](std::deque<ThreadMsg>& queue) {
+		queue.emplace_back(MSG_DISPATCH_INLINE, std::move(msg));
+	});
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateBatch
+//----------------------------------------------------------------------------
+size_t WorkerThreadPool::DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs)
+{
+	ASSERT_TRUE(m_created);
+
+	// Queue the whole batch on one worker with one lock; idle workers steal from it
+	Post(SelectWorker(), msgs.size(), [&msgs](std::deque<ThreadMsg>& queue) {
+		for (auto& msg : msgs)
+			queue.emplace_back(MSG_DISPATCH_DELEGATE, msg);
+	});
+	return msgs.size();
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInlineBatch
+//----------------------------------------------------------------------------
+size_t WorkerThreadPool::DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs)
+{
+	ASSERT_TRUE(m_created);
+
+	Post(SelectWorker(), msgs.size(), [&msgs](std::deque<ThreadMsg>& queue) {
+		for (auto& msg : msgs)
+			queue.emplace_back(MSG_DISPATCH_INLINE, std::move(msg));
+	});
+	return msgs.size();
+}
+
+//----------------------------------------------------------------------------
+// SelectWorker
+//----------------------------------------------------------------------------
+size_t WorkerThreadPool::SelectWorker()
+{
+	if (t_pool == this)
+		return t_workerIndex;
+	return m_next.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+}
+
+//----------------------------------------------------------------------------
+// Post
+//----------------------------------------------------------------------------
+template <class F>
+void WorkerThreadPool::Post(size_t index, size_t count, F push)
+{
+	if (count == 0)
+		return;
+
+	Worker& worker = *m_workers[index];
+	{
+		const std::lock_guard<std::mutex> lock(worker.lock);
+		push(worker.queue);
+		m_pending.fetch_add(count);
+	}
+
+	// Only pay for a wake-up system call if a worker is parked. Either a parking
+	// worker sees m_pending non-zero, or we see it counted in m_sleepers.
+	if (m_sleepers.load() > 0)
+	{
+		m_wakeSeq.fetch_add(1);
+		FutexWake(m_wakeSeq, count > 1);
+	}
+}
+
+//----------------------------------------------------------------------------
+// Pop
+//----------------------------------------------------------------------------
+bool WorkerThreadPool::Pop(size_t index, ThreadMsg& msg)
+{
+	// Own queue first, oldest message
+	{
+		Worker& worker = *m_workers[index];
+		const std::lock_guard<std::mutex> lock(worker.lock);
+		if (!worker.queue.empty())
+		{
+			msg = std::move(worker.queue.front());
+			worker.queue.pop_front();
+			m_pending.fetch_sub(1);
+			return true;
+		}
+	}
+
+	// Steal the newest message from another worker
+	for (size_t i = 1; i < m_workers.size(); i++)
+	{
+		Worker& victim = *m_workers[(index + i) % m_workers.size()];
+		const std::lock_guard<std::mutex> lock(victim.lock);
+		if (!victim.queue.empty())
+		{
+			msg = std::move(victim.queue.back());
+			victim.queue.pop_back();
+			m_pending.fetch_sub(1);
+			return true;
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------
+// Wait
+//----------------------------------------------------------------------------
+void WorkerThreadPool::Wait()
+{
+	// Announce the worker is parking, then re-check for work. A producer either
+	// sees m_sleepers set and bumps m_wakeSeq, or we see its message counted here.
+	const uint32_t seq = m_wakeSeq.load();
+	m_sleepers.fetch_add(1);
+	if (m_pending.load() == 0 && !m_exit.load())
+		FutexWait(m_wakeSeq, seq);
+	m_sleepers.fetch_sub(1);
+}
+
+//----------------------------------------------------------------------------
+// Process
+//----------------------------------------------------------------------------
+void WorkerThreadPool::Process(size_t index)
+{
+	t_pool = this;
+	t_workerIndex = index;
+	DelegateThreadScope scope(this);
+
+	while (1)
+	{
+		ThreadMsg msg;
+		if (!Pop(index, msg))
+		{
+			// Exit once every dispatched message has been invoked
+			if (m_exit.load() && m_pending.load() == 0)
+				break;
+			Wait();
+			continue;
+		}
+
+		switch (msg.GetId())
+		{
+			case MSG_DISPATCH_DELEGATE:
+			{
+				ASSERT_TRUE(msg.GetData() != NULL);
+
+				// Invoke the callback on a pool thread
+				DelegateMsgBase::Invoke(msg.GetData());
+				break;
+			}
+
+			case MSG_DISPATCH_INLINE:
+			{
+				ASSERT_TRUE(!msg.GetInline().Empty());
+
+				// Invoke the callback on a pool thread
+				msg.GetInline().Invoke();
+				break;
+			}
+
+			default:
+				ASSERT();
+		}
+	}
+
+	t_pool = nullptr;
+}
+
+#endif
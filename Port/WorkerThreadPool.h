@@ -0,0 +1,107 @@
+#ifndef _WORKER_THREAD_POOL_H
+#define _WORKER_THREAD_POOL_H
+
+// @see https://github.com/endurodave/AsyncMulticastDelegateCpp17
+
+#include "DelegateOpt.h"
+#if USE_STD_THREADS
+
+#include "IDelegateThread.h"
+#include "DataTypes.h"
+#include "ThreadMsg.h"
+#include <thread>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <string>
+
+/// @brief A DelegateThread backed by a pool of worker threads. Each worker owns a
+/// queue; a worker whose queue runs dry steals from the other workers. For callbacks
+/// that do not require thread affinity: messages may run concurrently and complete
+/// in any order.
+/// @details Messages dispatched from outside the pool are spread over the workers
+/// round robin. Messages dispatched by a callback running on a pool worker go to that
+/// worker's own queue. Idle workers park on a futex; a producer only makes a wake-up
+/// system call when a worker is parked.
+class WorkerThreadPool : public DelegateLib::DelegateThread
+{
+public:
+	/// Constructor
+	/// @param[in] threadName - the pool name.
+	/// @param[in] threadCount - the number of workers. 0 uses the hardware concurrency.
+	WorkerThreadPool(const CHAR* threadName, size_t threadCount = 0);
+
+	/// Destructor
+	~WorkerThreadPool();
+
+	/// Called once to create the worker threads
+	/// @return TRUE if threads are created. FALSE otherise.
+	BOOL CreateThread();
+
+	/// Called once a program exit to exit the worker threads. Messages already
+	/// dispatched are invoked before the workers exit.
+	void ExitThread();
+
+	/// @return The number of worker threads.
+	size_t GetThreadCount() const { return m_workers.size(); }
+
+	/// @return True if called from one of this pool's worker threads.
+	bool IsPoolThread() const;
+
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
+
+	virtual bool DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg);
+
+	virtual size_t DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs);
+
+	virtual size_t DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs);
+
+private:
+	WorkerThreadPool(const WorkerThreadPool&) = delete;
+	WorkerThreadPool& operator=(const WorkerThreadPool&) = delete;
+
+	/// One worker thread and its queue. The owner pops the oldest message; a thief
+	/// steals the newest, so the owner and a thief rarely contend for one message.
+	struct alignas(64) Worker
+	{
+		std::mutex lock;
+		std::deque<ThreadMsg> queue;
+		std::thread thread;
+	};
+
+	/// Entry point for worker index
+	void Process(size_t index);
+
+	/// Pop a message from worker index, or steal one from another worker
+	/// @return True if msg was set.
+	bool Pop(size_t index, ThreadMsg& msg);
+
+	/// @return The worker a new message is queued on
+	size_t SelectWorker();
+
+	/// Add messages to the queue of worker index and wake parked workers
+	template <class F>
+	void Post(size_t index, size_t count, F push);
+
+	/// Park the calling worker until a message is posted or the pool exits
+	void Wait();
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+
+	/// Number of queued messages across all workers
+	alignas(64) std::atomic<size_t> m_pending;
+
+	/// Futex word incremented to wake parked workers
+	alignas(64) std::atomic<uint32_t> m_wakeSeq;
+	std::atomic<size_t> m_sleepers;
+
+	std::atomic<size_t> m_next;
+	std::atomic<bool> m_exit;
+	bool m_created;
+	const std::string THREAD_NAME;
+};
+
+#endif
+
+#endif
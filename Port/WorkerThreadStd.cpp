@@ -3,7 +3,6 @@
 
 #include "WorkerThreadStd.h"
 #include "ThreadMsg.h"
-#include "Timer.h"
 #include <chrono>
 
 #ifdef WIN32
@@ -16,12 +15,14 @@ using namespace std::chrono;
 
 #define MSG_DISPATCH_DELEGATE	1
 #define MSG_EXIT_THREAD			2
-#define MSG_TIMER				3
+#define MSG_DISPATCH_INLINE		4
 
 //----------------------------------------------------------------------------
 // WorkerThread
 //----------------------------------------------------------------------------
-WorkerThread::WorkerThread(const CHAR* threadName) : m_thread(nullptr), m_timerExit(false), THREAD_NAME(threadName)
+WorkerThread::WorkerThread(const CHAR* threadName) : m_thread(nullptr), m_drained(0), m_skipped(), 
+	m_capacity(0), m_policy(OverflowPolicy::BLOCK), m_timeout(0), m_exiting(false), m_size(0), m_blocked(0), m_dropped(0),
+	m_queued(0), m_spinCount(0), m_starvationLimit(0), THREAD_NAME(threadName)
 {
 }
 
@@ -40,6 +41,10 @@ BOOL WorkerThread::CreateThread()
 {
 	if (!m_thread)
 	{
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_exiting = false;
+		}
 		m_thread = std::unique_ptr<std::thread>(new thread(&WorkerThread::Process, this));
 
 #ifdef WIN32
@@ -83,52 +88,317 @@ void WorkerThread::ExitThread()
 	if (!m_thread)
 		return;
 
-	// Create a new ThreadMsg
-	std::shared_ptr<ThreadMsg> threadMsg(new ThreadMsg(MSG_EXIT_THREAD, 0));
-
 	// Put exit thread message into the queue
-	{
-		lock_guard<mutex> lock(m_mutex);
-		m_queue.push(threadMsg);
-		m_cv.notify_one();
-	}
+	Post(ThreadMsg(MSG_EXIT_THREAD, 0));
 
     m_thread->join();
     m_thread = nullptr;
 }
 
+//----------------------------------------------------------------------------
+// SetQueueCapacity
+//----------------------------------------------------------------------------
+void WorkerThread::SetQueueCapacity(size_t capacity, OverflowPolicy policy, std::chrono::milliseconds timeout)
+{
+	// The worker thread reads the capacity without the lock
+	ASSERT_TRUE(!m_thread);
+
+	std::unique_lock<std::mutex> lk(m_mutex);
+	m_capacity = capacity;
+	m_policy = policy;
+	m_timeout = timeout;
+	m_size.store(m_queued.load());
+}
+
 //----------------------------------------------------------------------------
 // DispatchDelegate
 //----------------------------------------------------------------------------
-void WorkerThread::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
+bool WorkerThread::DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg)
 {
 	ASSERT_TRUE(m_thread);
 
-	// Create a new ThreadMsg
-    std::shared_ptr<ThreadMsg> threadMsg(new ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
-
 	// Add dispatch delegate msg to queue and notify worker thread
+	return Post(ThreadMsg(MSG_DISPATCH_DELEGATE, msg));
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInline
+//----------------------------------------------------------------------------
+bool WorkerThread::DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg)
+{
+	ASSERT_TRUE(m_thread);
+
+	// The inline message is moved into a preallocated queue slot; no heap allocation
+	return Post(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)));
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateBatch
+//----------------------------------------------------------------------------
+size_t WorkerThread::DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs)
+{
+	ASSERT_TRUE(m_thread);
+
+	// Add every msg to the queue under one lock, then notify the worker thread once
+	size_t accepted = 0;
+	std::vector<ThreadMsg> discarded;
+	std::unique_lock<std::mutex> lk(m_mutex);
+	for (auto& msg : msgs)
+		accepted += Enqueue(ThreadMsg(MSG_DISPATCH_DELEGATE, msg), lk, discarded) ? 1 : 0;
+	m_cv.notify_one();
+	return accepted;
+}
+
+//----------------------------------------------------------------------------
+// DispatchDelegateInlineBatch
+//----------------------------------------------------------------------------
+size_t WorkerThread::DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs)
+{
+	ASSERT_TRUE(m_thread);
+
+	size_t accepted = 0;
+	std::vector<ThreadMsg> discarded;
+	std::unique_lock<std::mutex> lk(m_mutex);
+	for (auto& msg : msgs)
+		accepted += Enqueue(ThreadMsg(MSG_DISPATCH_INLINE, std::move(msg)), lk, discarded) ? 1 : 0;
+	m_cv.notify_one();
+	return accepted;
+}
+
+//----------------------------------------------------------------------------
+// Post
+//----------------------------------------------------------------------------
+bool WorkerThread::Post(ThreadMsg&& msg)
+{
+	// Messages discarded to make room are destroyed once the lock is released, since
+	// destroying a message may run code that dispatches to this thread
+	std::vector<ThreadMsg> discarded;
 	std::unique_lock<std::mutex> lk(m_mutex);
-	m_queue.push(threadMsg);
+	const bool accepted = Enqueue(std::move(msg), lk, discarded);
 	m_cv.notify_one();
+	return accepted;
 }
 
 //----------------------------------------------------------------------------
-// TimerThread
+// Enqueue
 //----------------------------------------------------------------------------
-void WorkerThread::TimerThread()
+bool WorkerThread::Enqueue(ThreadMsg&& msg, std::unique_lock<std::mutex>& lk, std::vector<ThreadMsg>& discarded)
 {
-    while (!m_timerExit)
-    {
-        std::this_thread::sleep_for((std::chrono::milliseconds)100);
+	// The exit request is always queued
+	if (m_capacity == 0 || msg.GetId() == MSG_EXIT_THREAD || m_size.load() < m_capacity)
+	{
+		Push(std::move(msg));
+		return true;
+	}
+
+	switch (m_policy)
+	{
+		case OverflowPolicy::BLOCK:
+		case OverflowPolicy::BLOCK_TIMEOUT:
+		{
+			// The worker thread would wait on itself forever
+			if (m_thread && m_thread->get_id() == this_thread::get_id())
+				break;
+
+			// Wake the worker for any messages a batch dispatch queued before filling up
+			m_cv.notify_one();
+
+			// Announce the wait, then re-check. The worker either sees m_blocked set
+			// and notifies, or we see the room it made.
+			const auto deadline = steady_clock::now() + m_timeout;
+			m_blocked.fetch_add(1);
+			while (m_size.load() >= m_capacity)
+			{
+				// No worker remains to make room once the thread exits
+				if (m_exiting)
+				{
+					m_blocked.fetch_sub(1);
+					m_dropped.fetch_add(1, memory_order_relaxed);
+					return false;
+				}
+
+				if (m_policy == OverflowPolicy::BLOCK)
+					m_notFull.wait(lk);
+				else if (m_notFull.wait_until(lk, deadline) == cv_status::timeout && m_size.load() >= m_capacity)
+				{
+					m_blocked.fetch_sub(1);
+					m_dropped.fetch_add(1, memory_order_relaxed);
+					return false;
+				}
+			}
+			m_blocked.fetch_sub(1);
+			break;
+		}
 
-        std::shared_ptr<ThreadMsg> threadMsg (new ThreadMsg(MSG_TIMER, 0));
+		case OverflowPolicy::DROP_OLDEST:
+			if (DiscardOldest(static_cast<size_t>(msg.GetPriority()), discarded))
+				break;
+			m_dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+
+		case OverflowPolicy::COALESCE:
+			// Either a queued message or the new message is lost
+			m_dropped.fetch_add(1, memory_order_relaxed);
+			return Coalesce(msg, discarded);
+
+		case OverflowPolicy::DROP_NEWEST:
+		default:
+			m_dropped.fetch_add(1, memory_order_relaxed);
+			return false;
+	}
 
-        // Add timer msg to queue and notify worker thread
-        std::unique_lock<std::mutex> lk(m_mutex);
-        m_queue.push(threadMsg);
-        m_cv.notify_one();
-    }
+	Push(std::move(msg));
+	return true;
+}
+
+//----------------------------------------------------------------------------
+// DiscardOldest
+//----------------------------------------------------------------------------
+bool WorkerThread::DiscardOldest(size_t level, std::vector<ThreadMsg>& discarded)
+{
+	// Lowest priority first. Within a level, messages the worker took but has not
+	// started are older than those still queued.
+	for (size_t l = 0; l <= level; l++)
+	{
+		for (RingBuffer<ThreadMsg>* queue : { &m_drain[l], &m_queue[l] })
+		{
+			for (size_t i = 0; i < queue->Size(); i++)
+			{
+				if ((*queue)[i].IsDiscardable())
+				{
+					discarded.push_back(std::move((*queue)[i]));
+					queue->Erase(i);
+					if (queue == &m_drain[l])
+						m_drained--;
+					else
+						m_queued.store(m_queued.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+					m_size.fetch_sub(1);
+					m_dropped.fetch_add(1, memory_order_relaxed);
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------
+// Coalesce
+//----------------------------------------------------------------------------
+bool WorkerThread::Coalesce(ThreadMsg& msg, std::vector<ThreadMsg>& discarded)
+{
+	const void* key = msg.GetCoalesceKey();
+	if (!key)
+		return false;
+
+	// Replace in place, so the newer message keeps the queue position of the older.
+	// Newest first: queued messages, then those the worker took but has not started.
+	const size_t level = static_cast<size_t>(msg.GetPriority());
+	for (RingBuffer<ThreadMsg>* queue : { &m_queue[level], &m_drain[level] })
+	{
+		for (size_t i = queue->Size(); i-- > 0; )
+		{
+			if ((*queue)[i].GetCoalesceKey() == key && (*queue)[i].IsDiscardable())
+			{
+				discarded.push_back(std::move((*queue)[i]));
+				(*queue)[i] = std::move(msg);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+//----------------------------------------------------------------------------
+// Push
+//----------------------------------------------------------------------------
+void WorkerThread::Push(ThreadMsg&& msg)
+{
+	// The exit request is queued behind every message of every priority
+	size_t level = 0;
+	if (msg.GetId() != MSG_EXIT_THREAD)
+		level = static_cast<size_t>(msg.GetPriority());
+
+	m_queue[level].Push(std::move(msg));
+	m_queued.store(m_queued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	if (m_capacity != 0)
+		m_size.fetch_add(1);
+}
+
+//----------------------------------------------------------------------------
+// Release
+//----------------------------------------------------------------------------
+void WorkerThread::Release()
+{
+	// Dispatchers announce a wait in m_blocked before re-checking m_size. Waking them
+	// once the queue is half empty, rather than per free slot, lets a blocked producer
+	// refill in a burst instead of switching threads on every message.
+	const size_t size = m_size.fetch_sub(1) - 1;
+	if (size <= m_capacity / 2 && m_blocked.load() != 0)
+	{
+		std::unique_lock<std::mutex> lk(m_mutex);
+		m_notFull.notify_all();
+	}
+}
+
+//----------------------------------------------------------------------------
+// Refill
+//----------------------------------------------------------------------------
+void WorkerThread::Refill()
+{
+	for (size_t level = 0; level < DELEGATE_PRIORITIES; level++)
+	{
+		RingBuffer<ThreadMsg>& queue = m_queue[level];
+		RingBuffer<ThreadMsg>& drain = m_drain[level];
+		m_drained += queue.Size();
+
+		// Swap the buffers when possible, so no memory is allocated or copied 
+		// while holding the lock
+		if (drain.Empty())
+			queue.Swap(drain);
+		else
+		{
+			for (; !queue.Empty(); queue.Pop())
+				drain.Push(std::move(queue.Front()));
+		}
+	}
+	m_queued.store(0, std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+// SelectPriority
+//----------------------------------------------------------------------------
+size_t WorkerThread::SelectPriority()
+{
+	// Highest priority level holding a message
+	size_t selected = DELEGATE_PRIORITIES - 1;
+	while (m_drain[selected].Empty())
+		selected--;
+
+	// Unless a lower level has been passed over too many times. The exit request is
+	// never promoted, so the messages dispatched before it are invoked first.
+	const size_t limit = m_starvationLimit.load(std::memory_order_relaxed);
+	if (limit > 0)
+	{
+		for (size_t level = selected; level-- > 0; )
+		{
+			if (!m_drain[level].Empty() && m_skipped[level] >= limit &&
+				m_drain[level].Front().GetId() != MSG_EXIT_THREAD)
+			{
+				selected = level;
+				break;
+			}
+		}
+	}
+
+	for (size_t level = 0; level < DELEGATE_PRIORITIES; level++)
+	{
+		if (level == selected)
+			m_skipped[level] = 0;
+		else if (!m_drain[level].Empty())
+			m_skipped[level]++;
+	}
+	return selected;
 }
 
 //----------------------------------------------------------------------------
@@ -136,53 +406,101 @@ void WorkerThread::TimerThread()
 //----------------------------------------------------------------------------
 void WorkerThread::Process()
 {
-    m_timerExit = false;
-    std::thread timerThread(&WorkerThread::TimerThread, this);
+	DelegateThreadScope scope(this);
+
+	// Dispatchers that discard or replace queued messages also search m_drain, so the
+	// worker only touches it while holding the lock
+	const bool evicting = m_capacity != 0 &&
+		(m_policy == OverflowPolicy::DROP_OLDEST || m_policy == OverflowPolicy::COALESCE);
 
 	while (1)
 	{
-		std::shared_ptr<ThreadMsg> msg;
+		ThreadMsg msg;
 		{
-			// Wait for a message to be added to the queue
-			std::unique_lock<std::mutex> lk(m_mutex);
-			while (m_queue.empty())
-				m_cv.wait(lk);
+			std::unique_lock<std::mutex> lk(m_mutex, std::defer_lock);
+			if (evicting)
+				lk.lock();
 
-			if (m_queue.empty())
-				continue;
+			if (m_drained == 0)
+			{
+				// Poll briefly before blocking so closely spaced messages avoid the wake-up cost
+				if (lk.owns_lock())
+					lk.unlock();
+				const int spinCount = m_spinCount.load(std::memory_order_relaxed);
+				for (int i = 0; i < spinCount && m_queued.load(std::memory_order_relaxed) == 0; i++)
+					std::this_thread::yield();
+
+				// Wait for a message to be added to the queue
+				lk.lock();
+				while (m_queued.load(std::memory_order_relaxed) == 0)
+					m_cv.wait(lk);
+				Refill();
+			}
+			else if (m_queued.load(std::memory_order_relaxed) != 0)
+			{
+				// Take newly queued messages so a higher priority message does not wait
+				// behind the lower priority messages already taken
+				if (!lk.owns_lock())
+					lk.lock();
+				Refill();
+			}
 
-			msg = m_queue.front();
-			m_queue.pop();
+			RingBuffer<ThreadMsg>& drain = m_drain[SelectPriority()];
+			msg = std::move(drain.Front());
+			drain.Pop();
+			m_drained--;
 		}
 
-		switch (msg->GetId())
+		switch (msg.GetId())
 		{
 			case MSG_DISPATCH_DELEGATE:
 			{
-				ASSERT_TRUE(msg->GetData() != NULL);
-
-				// Convert the ThreadMsg void* data back to a DelegateMsg* 
-                auto delegateMsg = msg->GetData();
+				ASSERT_TRUE(msg.GetData() != NULL);
 
 				// Invoke the callback on the target thread
-				delegateMsg->GetDelegateInvoker()->DelegateInvoke(delegateMsg);
+				DelegateMsgBase::Invoke(msg.GetData());
 				break;
 			}
 
-            case MSG_TIMER:
-                Timer::ProcessTimers();
-                break;
+			case MSG_DISPATCH_INLINE:
+			{
+				ASSERT_TRUE(!msg.GetInline().Empty());
+
+				// Invoke the callback on the target thread
+				msg.GetInline().Invoke();
+				break;
+			}
 
 			case MSG_EXIT_THREAD:
 			{
-                m_timerExit = true;
-                timerThread.join();
-                return;
+				// Discard any messages drained after the exit request. They are destroyed
+				// once the lock is released, as Post() does.
+				std::vector<ThreadMsg> discarded;
+				std::unique_lock<std::mutex> lk(m_mutex);
+				for (auto& level : m_drain)
+				{
+					for (; !level.Empty(); level.Pop())
+						discarded.push_back(std::move(level.Front()));
+				}
+				m_drained = 0;
+
+				// Only messages still queued count against the capacity. Dispatchers 
+				// waiting for room are rejected until the thread is created again.
+				m_exiting = true;
+				if (m_capacity != 0)
+				{
+					m_size.store(m_queued.load());
+					m_notFull.notify_all();
+				}
+				lk.unlock();
+				return;
 			}
 
 			default:
 				ASSERT();
 		}
+		if (m_capacity != 0)
+			Release();
 	}
 }
 
@@ -9,17 +9,28 @@
 
 #include "IDelegateThread.h"
 #include "DataTypes.h"
+#include "ThreadMsg.h"
+#include "RingBuffer.h"
 #include <thread>
-#include <queue>
+#include <vector>
 #include <mutex>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 
-class ThreadMsg;
-
 class WorkerThread : public DelegateLib::DelegateThread
 {
 public:
+	/// Action taken when a message is dispatched to a full bounded queue
+	enum class OverflowPolicy
+	{
+		BLOCK,			///< Block the dispatching thread until the queue has room
+		BLOCK_TIMEOUT,	///< Block up to a timeout, then reject the new message
+		DROP_NEWEST,	///< Reject the new message
+		DROP_OLDEST,	///< Discard the oldest queued message of equal or lower priority
+		COALESCE		///< Replace a queued message with the same coalesce key, else reject
+	};
+
 	/// Constructor
 	WorkerThread(const CHAR* threadName);
 
@@ -39,7 +50,52 @@ public:
 	/// Get the ID of the currently executing thread
 	static std::thread::id GetCurrentThreadId();
 
-	virtual void DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
+	/// Set the number of times the worker polls for new messages, yielding between
+	/// polls, before blocking on the condition variable. Latency sensitive consumers 
+	/// avoid the wake-up cost between closely spaced messages. Default is 0.
+	/// @param[in] spinCount - the number of polls before blocking.
+	void SetSpinCount(int spinCount) { m_spinCount = spinCount; }
+
+	/// @return The number of polls before blocking.
+	int GetSpinCount() const { return m_spinCount; }
+
+	/// Set the anti-starvation limit. Messages are invoked highest DelegatePriority
+	/// first. A waiting lower priority message passed over this many times is invoked
+	/// next. 0, the default, invokes strictly by priority.
+	/// @param[in] limit - the number of messages a waiting message may be passed over.
+	void SetStarvationLimit(size_t limit) { m_starvationLimit = limit; }
+
+	/// @return The anti-starvation limit.
+	size_t GetStarvationLimit() const { return m_starvationLimit; }
+
+	/// Bound the queue. Messages dispatched and not yet invoked count against the
+	/// capacity; once full, policy decides the fate of each new message. A rejected 
+	/// message makes DispatchDelegate() return false. The worker thread dispatching to
+	/// itself never blocks, so BLOCK and BLOCK_TIMEOUT admit its messages over capacity.
+	/// Call before CreateThread().
+	/// @param[in] capacity - the maximum number of messages. 0, the default, is unbounded.
+	/// @param[in] policy - the overflow policy.
+	/// @param[in] timeout - the longest a BLOCK_TIMEOUT dispatch waits for room.
+	void SetQueueCapacity(size_t capacity, OverflowPolicy policy = OverflowPolicy::BLOCK,
+		std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+	/// @return The queue capacity, or 0 if unbounded.
+	size_t GetQueueCapacity() const { return m_capacity; }
+
+	/// @return The overflow policy.
+	OverflowPolicy GetOverflowPolicy() const { return m_policy; }
+
+	/// @return The number of messages rejected, discarded or replaced because the 
+	///		queue was full.
+	size_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+	virtual bool DispatchDelegate(std::shared_ptr<DelegateLib::DelegateMsgBase> msg);
+
+	virtual bool DispatchDelegateInline(DelegateLib::DelegateMsgInline&& msg);
+
+	virtual size_t DispatchDelegateBatch(const std::vector<std::shared_ptr<DelegateLib::DelegateMsgBase>>& msgs);
+
+	virtual size_t DispatchDelegateInlineBatch(std::vector<DelegateLib::DelegateMsgInline>&& msgs);
 
 private:
 	WorkerThread(const WorkerThread&) = delete;
@@ -48,14 +104,73 @@ private:
 	/// Entry point for the thread
 	void Process();
 
-    /// Entry point for timer thread
-    void TimerThread();
+	/// Add a message to the queue and notify the worker thread
+	/// @return True if the message was queued.
+	bool Post(ThreadMsg&& msg);
+
+	/// Add a message to the queue, applying the overflow policy if the bounded queue
+	/// is full. Caller holds m_mutex via lk, which a blocking policy may release. Queued
+	/// messages the policy discards are moved to discarded, for the caller to destroy 
+	/// after releasing m_mutex.
+	/// @return True if msg was queued or replaced a queued message.
+	bool Enqueue(ThreadMsg&& msg, std::unique_lock<std::mutex>& lk, std::vector<ThreadMsg>& discarded);
+
+	/// Discard the oldest discardable queued message at or below level, moving it to 
+	/// discarded. Messages the worker took but has not started count as queued. Caller
+	/// holds m_mutex.
+	/// @return True if a message was discarded.
+	bool DiscardOldest(size_t level, std::vector<ThreadMsg>& discarded);
+
+	/// Replace the newest queued message sharing the coalesce key of msg, moving the
+	/// replaced message to discarded. Messages the worker took but has not started 
+	/// count as queued. Caller holds m_mutex.
+	/// @return True if msg replaced a message.
+	bool Coalesce(ThreadMsg& msg, std::vector<ThreadMsg>& discarded);
+
+	/// Count an invoked message against the bounded queue and wake blocked dispatchers
+	void Release();
+
+	/// Add a message to the queue of its priority. Caller holds m_mutex.
+	void Push(ThreadMsg&& msg);
+
+	/// Move every queued message to m_drain. Caller holds m_mutex.
+	void Refill();
+
+	/// @return The priority level whose next message is invoked
+	size_t SelectPriority();
 
 	std::unique_ptr<std::thread> m_thread;
-	std::queue<std::shared_ptr<ThreadMsg>> m_queue;
+
+	/// One queue per DelegatePriority level
+	RingBuffer<ThreadMsg> m_queue[DelegateLib::DELEGATE_PRIORITIES];
+
+	/// Messages taken from m_queue, per priority level. Only accessed by the worker thread,
+	/// unless the overflow policy discards queued messages; dispatchers then search it
+	/// too, and every access holds m_mutex.
+	RingBuffer<ThreadMsg> m_drain[DelegateLib::DELEGATE_PRIORITIES];
+	size_t m_drained;
+
+	/// Times each level was passed over while holding a message. Worker thread only.
+	size_t m_skipped[DelegateLib::DELEGATE_PRIORITIES];
+
 	std::mutex m_mutex;
 	std::condition_variable m_cv;
-    std::atomic<bool> m_timerExit;
+
+	/// Bounded queue. m_size counts messages dispatched and not yet invoked, and is 
+	/// only maintained when m_capacity is non-zero.
+	size_t m_capacity;
+	OverflowPolicy m_policy;
+	std::chrono::milliseconds m_timeout;
+	std::condition_variable m_notFull;
+	bool m_exiting;		// Set under m_mutex once the worker exits, until CreateThread()
+	std::atomic<size_t> m_size;
+	std::atomic<size_t> m_blocked;
+	std::atomic<size_t> m_dropped;
+
+	/// Number of messages within m_queue. Polled by the worker without the lock.
+	std::atomic<size_t> m_queued;
+	std::atomic<int> m_spinCount;
+	std::atomic<size_t> m_starvationLimit;
 	const std::string THREAD_NAME;
 };
 
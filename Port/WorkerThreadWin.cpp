@@ -4,7 +4,6 @@
 #include "WorkerThreadWin.h"
 #include "ThreadMsg.h"
 #include "UserMsgs.h"
-#include "Timer.h"
 
 using namespace DelegateLib;
 
@@ -15,26 +14,16 @@ WorkerThread::WorkerThread(const CHAR* threadName) : ThreadWin(threadName)
 {
 }
 
-//----------------------------------------------------------------------------
-// TimerExpired
-//----------------------------------------------------------------------------
-void CALLBACK WorkerThread::TimerExpired(UINT uTimerID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2)
-{
-	WorkerThread* thread = reinterpret_cast<WorkerThread*>(dwUser);
-	thread->PostThreadMessage(WM_USER_TIMER);
-}
-
 //----------------------------------------------------------------------------
 // Process
 //----------------------------------------------------------------------------
 unsigned long WorkerThread::Process(void* parameter)
 {
+	DelegateThreadScope scope(this);
+
 	MSG msg;
 	BOOL bRet;
 
-	// Start periodic timer
-	MMRESULT timerId = timeSetEvent(100, 10, &WorkerThread::TimerExpired, reinterpret_cast<DWORD>(this), TIME_PERIODIC);
-
 	while ((bRet = GetMessage(&msg, NULL, WM_USER_BEGIN, WM_USER_END)) != 0)
 	{
 		switch (msg.message)
@@ -48,22 +37,14 @@ unsigned long WorkerThread::Process(void* parameter)
 
                 ASSERT_TRUE(threadMsg->GetData() != NULL);
 
-                // Convert the ThreadMsg void* data back to a DelegateMsg* 
-                auto delegateMsg = threadMsg->GetData();
-
                 // Invoke the callback on the target thread
-                delegateMsg->GetDelegateInvoker()->DelegateInvoke(delegateMsg);
+                DelegateMsgBase::Invoke(threadMsg->GetData());
 
                 delete threadMsg;
 				break;
 			}
 
-			case WM_USER_TIMER:
-				Timer::ProcessTimers();
-				break;
-
 			case WM_EXIT_THREAD:
-				timeKillEvent(timerId);
 				return 0;
 
 			default:
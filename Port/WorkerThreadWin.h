@@ -20,9 +20,6 @@ public:
 private:
 	/// The worker thread entry function
 	virtual unsigned long Process (void* parameter);
-
-	/// Timer callback called when the timer expires. 
-	static void CALLBACK TimerExpired(UINT uTimerID, UINT uMsg, DWORD_PTR dwUser, DWORD_PTR dw1, DWORD_PTR dw2);
 };
 
 #endif
@@ -268,6 +268,7 @@ void CoordinatesChangedCallbackError3(std::shared_ptr<const Coordinates>* c) {}
 void CoordinatesChangedCallbackError4(const std::shared_ptr<const Coordinates>* c) {}
 
 extern void DelegateUnitTests();
+extern void DelegateBenchmarks();
 
 //------------------------------------------------------------------------------
 // main
@@ -300,6 +301,11 @@ int main(void)
 	DelegateUnitTests();
 #endif
 
+	// Run performance benchmarks (build with ENABLE_BENCHMARKS to run)
+#ifdef DELEGATE_BENCHMARKS
+	DelegateBenchmarks();
+#endif
+
 	// Create a delegate bound to a free function then invoke
 	DelegateFree<void(int)> delegateFree = MakeDelegate(&FreeFuncInt);
 	delegateFree(123);